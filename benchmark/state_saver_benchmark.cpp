@@ -0,0 +1,248 @@
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2018 - 2021 Daniil Goncharov <neargye@gmail.com>.
+//
+// Permission is hereby  granted, free of charge, to any  person obtaining a copy
+// of this software and associated  documentation files (the "Software"), to deal
+// in the Software  without restriction, including without  limitation the rights
+// to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+// copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Measures construction, dismiss(), restore() and destructor cost of every saver flavor against a
+// hand-written save/restore, and prints the results as JSON to stdout.
+//
+// Usage: state_saver_benchmark [--min-time-ms N]
+
+#include <state_saver.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <new>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+#if defined(STATE_SAVER_FORCE_MOVE_ASSIGNABLE)
+constexpr const char* mode_name = "force_move_assignable";
+#elif defined(STATE_SAVER_FORCE_COPY_ASSIGNABLE)
+constexpr const char* mode_name = "force_copy_assignable";
+#else
+constexpr const char* mode_name = "default";
+#endif
+
+using clock_type = std::chrono::steady_clock;
+
+// Total bytes of snapshots kept alive by one batch, so huge payloads run in small batches.
+constexpr std::size_t batch_bytes_budget = std::size_t{128} * 1024 * 1024;
+constexpr std::size_t max_batch_size = 1024;
+constexpr int min_rounds = 3;
+constexpr int max_rounds = 100000;
+
+clock_type::duration min_time = std::chrono::milliseconds{200};
+
+#if defined(__GNUC__) || defined(__clang__)
+template <typename T>
+void escape(T& value) noexcept {
+  __asm__ __volatile__("" : : "r"(&value) : "memory");
+}
+#else
+void* volatile escape_sink = nullptr;
+
+template <typename T>
+void escape(T& value) noexcept {
+  escape_sink = &value;
+}
+#endif
+
+// Hand-written save/restore, the baseline every saver is compared with.
+template <typename T>
+class manual_saver {
+  T& previous_ref_;
+  T previous_value_;
+  bool dismissed_ = false;
+
+ public:
+  explicit manual_saver(T& object) : previous_ref_{object}, previous_value_{object} {}
+
+  manual_saver(const manual_saver&) = delete;
+  manual_saver& operator=(const manual_saver&) = delete;
+
+  void dismiss() noexcept {
+    dismissed_ = true;
+  }
+
+  void restore() {
+    previous_ref_ = previous_value_;
+  }
+
+  ~manual_saver() {
+    if (!dismissed_) {
+      previous_ref_ = std::move(previous_value_);
+    }
+  }
+};
+
+struct pod_32 {
+  int a;
+  int b;
+  double c;
+  char d[16];
+};
+
+struct pod_4k {
+  unsigned char data[4096];
+};
+
+enum phase { construct, restore, destroy, dismiss, destroy_dismissed, phase_count };
+
+constexpr const char* phase_names[phase_count] = {"construct", "restore", "destroy", "dismiss", "destroy_dismissed"};
+
+struct result {
+  const char* saver;
+  const char* payload;
+  std::size_t bytes;
+  std::size_t batch;
+  int rounds;
+  double ns_per_op[phase_count];
+};
+
+std::vector<result> results;
+
+template <typename S>
+struct slot {
+  alignas(S) unsigned char data[sizeof(S)];
+};
+
+double elapsed_ns(clock_type::time_point begin, clock_type::time_point end, std::size_t ops) {
+  return std::chrono::duration<double, std::nano>(end - begin).count() / static_cast<double>(ops);
+}
+
+template <typename S, typename T>
+void bench_saver(const char* saver_name, const char* payload_name, std::size_t bytes, T& object) {
+  const std::size_t batch = std::max<std::size_t>(1, std::min(max_batch_size, batch_bytes_budget / std::max<std::size_t>(1, bytes)));
+  std::vector<slot<S>> slots(batch);
+  std::vector<S*> savers(batch, nullptr);
+
+  result r{saver_name, payload_name, bytes, batch, 0, {}};
+  std::fill(std::begin(r.ns_per_op), std::end(r.ns_per_op), std::numeric_limits<double>::max());
+
+  const auto deadline = clock_type::now() + min_time;
+  for (; r.rounds < min_rounds || (r.rounds < max_rounds && clock_type::now() < deadline); ++r.rounds) {
+    clock_type::time_point t[phase_count + 2];
+
+    t[0] = clock_type::now();
+    for (std::size_t i = 0; i < batch; ++i) {
+      savers[i] = ::new (static_cast<void*>(slots[i].data)) S{object};
+    }
+    t[1] = clock_type::now();
+    for (std::size_t i = 0; i < batch; ++i) {
+      savers[i]->restore();
+      escape(object);
+    }
+    t[2] = clock_type::now();
+    for (std::size_t i = 0; i < batch; ++i) {
+      savers[i]->~S();
+      escape(object);
+    }
+    t[3] = clock_type::now();
+
+    for (std::size_t i = 0; i < batch; ++i) {
+      savers[i] = ::new (static_cast<void*>(slots[i].data)) S{object};
+    }
+    t[4] = clock_type::now();
+    for (std::size_t i = 0; i < batch; ++i) {
+      savers[i]->dismiss();
+      escape(*savers[i]);
+    }
+    t[5] = clock_type::now();
+    for (std::size_t i = 0; i < batch; ++i) {
+      savers[i]->~S();
+      escape(object);
+    }
+    t[6] = clock_type::now();
+
+    const double ns[phase_count] = {elapsed_ns(t[0], t[1], batch),
+                                    elapsed_ns(t[1], t[2], batch),
+                                    elapsed_ns(t[2], t[3], batch),
+                                    elapsed_ns(t[4], t[5], batch),
+                                    elapsed_ns(t[5], t[6], batch)};
+    for (int p = 0; p < phase_count; ++p) {
+      r.ns_per_op[p] = std::min(r.ns_per_op[p], ns[p]);
+    }
+  }
+
+  results.push_back(r);
+}
+
+template <typename T>
+void bench_payload(const char* payload_name, std::size_t bytes, T object) {
+  bench_saver<manual_saver<T>>("manual", payload_name, bytes, object);
+  bench_saver<state_saver::saver_exit<T>>("saver_exit", payload_name, bytes, object);
+  bench_saver<state_saver::saver_fail<T>>("saver_fail", payload_name, bytes, object);
+  bench_saver<state_saver::saver_success<T>>("saver_success", payload_name, bytes, object);
+}
+
+void print_results() {
+  std::printf("{\n");
+  std::printf("  \"library\": \"state_saver\",\n");
+  std::printf("  \"version\": \"%d.%d.%d\",\n", STATE_SAVER_VERSION_MAJOR, STATE_SAVER_VERSION_MINOR, STATE_SAVER_VERSION_PATCH);
+  std::printf("  \"mode\": \"%s\",\n", mode_name);
+  std::printf("  \"unit\": \"ns_per_op\",\n");
+  std::printf("  \"results\": [\n");
+  for (std::size_t i = 0; i < results.size(); ++i) {
+    const result& r = results[i];
+    std::printf("    {\"saver\": \"%s\", \"payload\": \"%s\", \"bytes\": %zu, \"batch\": %zu, \"rounds\": %d",
+                r.saver, r.payload, r.bytes, r.batch, r.rounds);
+    for (int p = 0; p < phase_count; ++p) {
+      std::printf(", \"%s\": %.3f", phase_names[p], r.ns_per_op[p]);
+    }
+    std::printf("}%s\n", i + 1 < results.size() ? "," : "");
+  }
+  std::printf("  ]\n");
+  std::printf("}\n");
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  for (int i = 1; i < argc; ++i) {
+    if (std::strcmp(argv[i], "--min-time-ms") == 0 && i + 1 < argc) {
+      min_time = std::chrono::milliseconds{std::strtol(argv[++i], nullptr, 10)};
+    } else {
+      std::fprintf(stderr, "Usage: %s [--min-time-ms N]\n", argv[0]);
+      return 1;
+    }
+  }
+
+  bench_payload("int", sizeof(int), 42);
+  bench_payload("pod_32", sizeof(pod_32), pod_32{1, 2, 3.0, "pod"});
+  bench_payload("pod_4k", sizeof(pod_4k), pod_4k{{1, 2, 3}});
+  bench_payload("string_64", 64, std::string(64, 's'));
+  bench_payload("vector_1k", std::size_t{1} << 10, std::vector<unsigned char>(std::size_t{1} << 10, 0xAB));
+  bench_payload("vector_64k", std::size_t{64} << 10, std::vector<unsigned char>(std::size_t{64} << 10, 0xAB));
+  bench_payload("vector_1m", std::size_t{1} << 20, std::vector<unsigned char>(std::size_t{1} << 20, 0xAB));
+  bench_payload("vector_64m", std::size_t{64} << 20, std::vector<unsigned char>(std::size_t{64} << 20, 0xAB));
+
+  print_results();
+
+  return 0;
+}
@@ -0,0 +1,148 @@
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2018 - 2021 Daniil Goncharov <neargye@gmail.com>.
+//
+// Permission is hereby  granted, free of charge, to any  person obtaining a copy
+// of this software and associated  documentation files (the "Software"), to deal
+// in the Software  without restriction, including without  limitation the rights
+// to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+// copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Measures the cost of the uncaught exceptions counter used by on_fail_policy and on_success_policy, and of
+// saver scopes in a tight loop, and prints the results as JSON to stdout.
+// On GCC/Clang before C++17 the counter is compared with calling __cxa_get_globals() on each check.
+//
+// Usage: uncaught_exceptions_benchmark [--min-time-ms N]
+
+#include <state_saver.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+constexpr std::size_t loop_size = 1 << 16;
+constexpr int min_rounds = 3;
+constexpr int max_rounds = 100000;
+
+clock_type::duration min_time = std::chrono::milliseconds{200};
+
+#if defined(__GNUC__) || defined(__clang__)
+template <typename T>
+void escape(T& value) noexcept {
+  __asm__ __volatile__("" : : "r"(&value) : "memory");
+}
+#else
+void* volatile escape_sink = nullptr;
+
+template <typename T>
+void escape(T& value) noexcept {
+  escape_sink = &value;
+}
+#endif
+
+struct result {
+  const char* name;
+  int rounds;
+  double ns_per_op;
+};
+
+std::vector<result> results;
+
+template <typename F>
+void bench(const char* name, F f) {
+  result r{name, 0, std::numeric_limits<double>::max()};
+  const auto deadline = clock_type::now() + min_time;
+  for (; r.rounds < min_rounds || (r.rounds < max_rounds && clock_type::now() < deadline); ++r.rounds) {
+    const auto begin = clock_type::now();
+    for (std::size_t i = 0; i < loop_size; ++i) {
+      f();
+    }
+    const auto end = clock_type::now();
+    r.ns_per_op = std::min(r.ns_per_op, std::chrono::duration<double, std::nano>(end - begin).count() / static_cast<double>(loop_size));
+  }
+  results.push_back(r);
+}
+
+#if (defined(__clang__) || defined(__GNUC__)) && __cplusplus < 201700L
+// Previous implementation, one call per check.
+int uncached_uncaught_exceptions() noexcept {
+  return static_cast<int>(*(reinterpret_cast<unsigned int*>(static_cast<char*>(static_cast<void*>(state_saver::detail::__cxa_get_globals())) + sizeof(void*))));
+}
+#endif
+
+template <typename S>
+void bench_saver(const char* name) {
+  int value = 0;
+  bench(name, [&value]() {
+    S saver{value};
+    ++value;
+    escape(value);
+  });
+}
+
+void print_results() {
+  std::printf("{\n");
+  std::printf("  \"library\": \"state_saver\",\n");
+  std::printf("  \"version\": \"%d.%d.%d\",\n", STATE_SAVER_VERSION_MAJOR, STATE_SAVER_VERSION_MINOR, STATE_SAVER_VERSION_PATCH);
+  std::printf("  \"cplusplus\": %ld,\n", static_cast<long>(__cplusplus));
+  std::printf("  \"unit\": \"ns_per_op\",\n");
+  std::printf("  \"results\": [\n");
+  for (std::size_t i = 0; i < results.size(); ++i) {
+    const result& r = results[i];
+    std::printf("    {\"name\": \"%s\", \"rounds\": %d, \"ns_per_op\": %.3f}%s\n", r.name, r.rounds, r.ns_per_op, i + 1 < results.size() ? "," : "");
+  }
+  std::printf("  ]\n");
+  std::printf("}\n");
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  for (int i = 1; i < argc; ++i) {
+    if (std::strcmp(argv[i], "--min-time-ms") == 0 && i + 1 < argc) {
+      min_time = std::chrono::milliseconds{std::strtol(argv[++i], nullptr, 10)};
+    } else {
+      std::fprintf(stderr, "Usage: %s [--min-time-ms N]\n", argv[0]);
+      return 1;
+    }
+  }
+
+  bench("uncaught_exceptions", []() {
+    int count = state_saver::detail::uncaught_exceptions();
+    escape(count);
+  });
+#if (defined(__clang__) || defined(__GNUC__)) && __cplusplus < 201700L
+  bench("uncached_uncaught_exceptions", []() {
+    int count = uncached_uncaught_exceptions();
+    escape(count);
+  });
+#endif
+  bench_saver<state_saver::saver_exit<int>>("saver_exit_scope");
+  bench_saver<state_saver::saver_fail<int>>("saver_fail_scope");
+  bench_saver<state_saver::saver_success<int>>("saver_success_scope");
+
+  print_results();
+
+  return 0;
+}
@@ -0,0 +1,74 @@
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2018 - 2021 Daniil Goncharov <neargye@gmail.com>.
+//
+// Permission is hereby  granted, free of charge, to any  person obtaining a copy
+// of this software and associated  documentation files (the "Software"), to deal
+// in the Software  without restriction, including without  limitation the rights
+// to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+// copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// Built without exceptions, restore is driven by the returned status.
+
+#include <state_saver.hpp>
+
+#include <iostream>
+#include <system_error>
+
+std::error_code foo1(int& a) {
+  std::error_code ec;
+  state_saver::status_saver_fail<decltype(a), std::error_code> state_saver{a, ec}; // State saver on failed status.
+
+  a = 1;
+  std::cout << "foo1 a = " << a << std::endl;
+  ec = std::make_error_code(std::errc::invalid_argument);
+  return ec;
+  // Original state will automatically restored, on failed status.
+}
+
+std::error_code foo2(int& a) {
+  std::error_code ec;
+  state_saver::status_saver_fail<decltype(a), std::error_code> state_saver{a, ec}; // State saver on failed status.
+
+  a = 2;
+  std::cout << "foo2 a = " << a << std::endl;
+  return ec;
+  // Original state will not automatically restored, on success status.
+}
+
+bool foo3(int& a) {
+  bool ok = true;
+  state_saver::status_saver_success<decltype(a), bool> state_saver{a, ok}; // State saver on success status.
+
+  a = 3;
+  std::cout << "foo3 a = " << a << std::endl;
+  return ok;
+  // Original state will automatically restored, on success status.
+}
+
+int main() {
+  int a = 0;
+  std::cout << "main a = " << a << std::endl;
+
+  foo1(a);
+  std::cout << "main a = " << a << std::endl;
+
+  foo2(a);
+  std::cout << "main a = " << a << std::endl;
+
+  foo3(a);
+  std::cout << "main a = " << a << std::endl;
+
+  return 0;
+}
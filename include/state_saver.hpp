@@ -36,7 +36,12 @@
 #define STATE_SAVER_VERSION_MINOR 9
 #define STATE_SAVER_VERSION_PATCH 1
 
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <new>
 #include <type_traits>
+#include <utility>
 #if (defined(_MSC_VER) && _MSC_VER >= 1900) || ((defined(__clang__) || defined(__GNUC__)) && __cplusplus >= 201700L)
 #include <exception>
 #endif
@@ -52,6 +57,9 @@
 // STATE_SAVER_FORCE_MOVE_ASSIGNABLE restore on scope exit will be move assigned.
 // STATE_SAVER_FORCE_COPY_ASSIGNABLE restore on scope exit will be copy assigned.
 
+// state_saver restore settings:
+// STATE_SAVER_COMPARE_BEFORE_RESTORE restore will be skipped if the object is equal to the saved value.
+
 #if !defined(STATE_SAVER_MAY_THROW_RESTORE) && !defined(STATE_SAVER_NO_THROW_RESTORE) && !defined(STATE_SAVER_SUPPRESS_THROW_RESTORE)
 #  define STATE_SAVER_MAY_THROW_RESTORE
 #elif (defined(STATE_SAVER_MAY_THROW_RESTORE) + defined(STATE_SAVER_NO_THROW_RESTORE) + defined(STATE_SAVER_SUPPRESS_THROW_RESTORE)) > 1
@@ -68,6 +76,10 @@
 
 namespace state_saver {
 
+// status_traits<S>::failed(status) tells status savers whether status reports failure, may be specialized.
+template <typename S>
+struct status_traits;
+
 namespace detail {
 
 #if defined(STATE_SAVER_SUPPRESS_THROW_RESTORE) && (defined(__cpp_exceptions) || defined(__EXCEPTIONS) || defined(_CPPUNWIND))
@@ -87,8 +99,18 @@ inline int uncaught_exceptions() noexcept {
 #elif (defined(__clang__) || defined(__GNUC__)) && __cplusplus < 201700L
 struct __cxa_eh_globals;
 extern "C" __cxa_eh_globals* __cxa_get_globals() noexcept;
+// Exception globals of a thread do not move, the pointer is cached to avoid a call on each policy check.
+// Constant initialized thread_local needs no guard.
+inline char* cxa_eh_globals() noexcept {
+  static thread_local char* globals = nullptr;
+  if (globals == nullptr) {
+    globals = static_cast<char*>(static_cast<void*>(__cxa_get_globals()));
+  }
+  return globals;
+}
+
 inline int uncaught_exceptions() noexcept {
-  return static_cast<int>(*(reinterpret_cast<unsigned int*>(static_cast<char*>(static_cast<void*>(__cxa_get_globals())) + sizeof(void*))));
+  return static_cast<int>(*(reinterpret_cast<unsigned int*>(cxa_eh_globals() + sizeof(void*))));
 }
 #else
 inline int uncaught_exceptions() noexcept {
@@ -141,20 +163,119 @@ class on_success_policy {
   }
 };
 
-template <typename U, typename P>
-class state_saver {
-  using T = typename std::remove_reference<U>::type;
+// Trivial standard-layout types are saved with memcpy and restored with trivial copy assignment, without calling a user operator=.
+// Empty and volatile types are excluded, memcpy over them is not equivalent to assignment.
+template <typename T>
+struct is_trivially_restorable : std::integral_constant<bool, std::is_trivial<T>::value && std::is_standard_layout<T>::value && !std::is_empty<T>::value && !std::is_volatile<T>::value> {};
+
+template <typename T, typename = void>
+struct is_equality_comparable : std::false_type {};
+
+template <typename T>
+struct is_equality_comparable<T, typename std::enable_if<std::is_convertible<decltype(std::declval<const T&>() == std::declval<const T&>()), bool>::value>::type> : std::true_type {};
+
+#if defined(STATE_SAVER_COMPARE_BEFORE_RESTORE)
+template <typename T, bool = !std::is_trivially_copyable<T>::value && is_equality_comparable<T>::value>
+struct is_nothrow_compare : std::true_type {};
+
+template <typename T>
+struct is_nothrow_compare<T, true> : std::integral_constant<bool, noexcept(static_cast<bool>(std::declval<const T&>() == std::declval<const T&>()))> {};
+#else
+template <typename T>
+struct is_nothrow_compare : std::true_type {};
+#endif
+
+template <typename T, bool = is_trivially_restorable<T>::value>
+class snapshot {
+  T value_;
+
+  // Bytewise for trivially copyable types, operator== otherwise, never equal if neither is available.
+  bool equal(const T& object, std::true_type, bool) const noexcept {
+    return std::memcmp(std::addressof(value_), std::addressof(object), sizeof(T)) == 0;
+  }
+
+  bool equal(const T& object, std::false_type, std::true_type) const noexcept(is_nothrow_compare<T>::value) {
+    return static_cast<bool>(value_ == object);
+  }
+
+  bool equal(const T&, std::false_type, std::false_type) const noexcept {
+    return false;
+  }
+
+ public:
+  explicit snapshot(T& object) noexcept(std::is_nothrow_constructible<T, T&>::value) : value_{object} {}
+
+  // Uses-allocator construction, T(object, alloc) or T(std::allocator_arg, alloc, object).
+  template <typename A, typename = typename std::enable_if<std::is_constructible<T, T&, const A&>::value>::type>
+  snapshot(T& object, const A& alloc) noexcept(std::is_nothrow_constructible<T, T&, const A&>::value) : value_(object, alloc) {}
+
+  template <typename A, typename = typename std::enable_if<!std::is_constructible<T, T&, const A&>::value>::type, typename = void>
+  snapshot(T& object, const A& alloc) noexcept(std::is_nothrow_constructible<T, std::allocator_arg_t, const A&, T&>::value) : value_(std::allocator_arg, alloc, object) {}
+
+  bool equal(const T& object) const noexcept(is_nothrow_compare<T>::value) {
+    return equal(object, std::is_trivially_copyable<T>{}, is_equality_comparable<T>{});
+  }
+
+  template <typename A>
+  void restore(T& object) noexcept(std::is_nothrow_assignable<T&, A>::value && is_nothrow_compare<T>::value) {
+#if defined(STATE_SAVER_COMPARE_BEFORE_RESTORE)
+    if (equal(object)) {
+      return;
+    }
+#endif
+    object = static_cast<A>(value_);
+  }
+};
+
+template <typename T>
+class snapshot<T, true> {
+  T value_;
+
+ public:
+  explicit snapshot(T& object) noexcept {
+    std::memcpy(std::addressof(value_), std::addressof(object), sizeof(T));
+  }
+
+  bool equal(const T& object) const noexcept {
+    return std::memcmp(std::addressof(value_), std::addressof(object), sizeof(T)) == 0;
+  }
+
+  template <typename A>
+  void restore(T& object) noexcept {
+#if defined(STATE_SAVER_COMPARE_BEFORE_RESTORE)
+    if (equal(object)) {
+      return;
+    }
+#endif
+    // Trivial copy assignment, not memcpy: when object is a base subobject its tail padding may hold members of the derived class.
+    object = value_;
+  }
+};
+
+// Argument type of operator= on restore, according to the assignable settings.
+template <typename T>
+struct restore_assignable {
 #if defined(STATE_SAVER_FORCE_MOVE_ASSIGNABLE)
-  using assignable_t = T&&;
+  using type = T&&;
 #elif defined(STATE_SAVER_FORCE_COPY_ASSIGNABLE)
-  using assignable_t = T&;
+  using type = T&;
 #else
-  using assignable_t = typename std::conditional<
+  using type = typename std::conditional<
       std::is_nothrow_assignable<T&, T&&>::value ||
           !std::is_assignable<T&, T&>::value ||
           (!std::is_nothrow_assignable<T&, T&>::value && std::is_assignable<T&, T&&>::value),
       T&&, T&>::type;
 #endif
+};
+
+template <typename U>
+class saved_object {
+ public:
+  using type = typename std::remove_reference<U>::type;
+
+ private:
+  using T = type;
+  using assignable_t = typename restore_assignable<T>::type;
 
   static_assert(!std::is_const<T>::value,
                 "state_saver requires not const type.");
@@ -170,8 +291,6 @@ class state_saver {
                 "state_saver requires copy constructible.");
   static_assert(std::is_assignable<T&, assignable_t>::value,
                 "state_saver requires operator=.");
-  static_assert(std::is_same<P, on_exit_policy>::value || std::is_same<P, on_fail_policy>::value || std::is_same<P, on_success_policy>::value,
-                "state_saver requires on_exit_policy, on_fail_policy or on_success_policy.");
 #if defined(STATE_SAVER_NO_THROW_RESTORE)
   static_assert(std::is_nothrow_assignable<T&, assignable_t>::value,
                 "state_saver requires noexcept operator=.");
@@ -181,9 +300,95 @@ class state_saver {
                 "state_saver requires nothrow constructible.");
 #endif
 
-  P policy_;
   T& previous_ref_;
-  T previous_value_;
+  snapshot<T> previous_value_;
+
+ public:
+  static constexpr bool is_nothrow_constructible = std::is_nothrow_constructible<T, T&>::value;
+  static constexpr bool is_copy_assignable = std::is_assignable<T&, T&>::value;
+  static constexpr bool is_nothrow_copy_assignable = std::is_nothrow_assignable<T&, T&>::value && is_nothrow_compare<T>::value;
+  static constexpr bool is_nothrow_restore = std::is_nothrow_assignable<T&, assignable_t>::value && is_nothrow_compare<T>::value;
+
+  explicit saved_object(T& object) noexcept(is_nothrow_constructible)
+      : previous_ref_{object},
+        previous_value_{object} {}
+
+  template <typename A>
+  saved_object(T& object, const A& alloc) noexcept(noexcept(snapshot<T>{object, alloc}))
+      : previous_ref_{object},
+        previous_value_{object, alloc} {}
+
+  // Restores by copy, the saved value stays usable.
+  void copy_restore() noexcept(is_nothrow_copy_assignable) {
+    previous_value_.template restore<T&>(previous_ref_);
+  }
+
+  // Restores on scope exit, according to the assignable settings.
+  void restore() noexcept(is_nothrow_restore) {
+    previous_value_.template restore<assignable_t>(previous_ref_);
+  }
+};
+
+// Saved objects of a multi-object saver. Restored in reverse order.
+template <typename... U>
+class saved_objects {
+ public:
+  static constexpr bool is_nothrow_constructible = true;
+  static constexpr bool is_copy_assignable = true;
+  static constexpr bool is_nothrow_copy_assignable = true;
+  static constexpr bool is_nothrow_restore = true;
+
+  void copy_restore() noexcept {}
+
+  void restore() noexcept {}
+};
+
+// Saved object of a multi-object saver, distinct type for each position.
+template <std::size_t I, typename U>
+class saved_objects_element : public saved_object<U> {
+ public:
+  using saved_object<U>::saved_object;
+};
+
+// Objects are bases, so each one may be placed in the tail padding of the previous ones.
+template <typename U, typename... R>
+class saved_objects<U, R...> : public saved_objects<R...>, private saved_objects_element<sizeof...(R), U> {
+  using base_t = saved_objects<R...>;
+  using object_t = saved_objects_element<sizeof...(R), U>;
+
+ public:
+  static constexpr bool is_nothrow_constructible = saved_object<U>::is_nothrow_constructible && base_t::is_nothrow_constructible;
+  static constexpr bool is_copy_assignable = saved_object<U>::is_copy_assignable && base_t::is_copy_assignable;
+  static constexpr bool is_nothrow_copy_assignable = saved_object<U>::is_nothrow_copy_assignable && base_t::is_nothrow_copy_assignable;
+  static constexpr bool is_nothrow_restore = saved_object<U>::is_nothrow_restore && base_t::is_nothrow_restore;
+
+  explicit saved_objects(typename saved_object<U>::type& object, typename saved_object<R>::type&... objects) noexcept(is_nothrow_constructible)
+      : base_t{objects...},
+        object_t{object} {}
+
+  void copy_restore() noexcept(is_nothrow_copy_assignable) {
+    base_t::copy_restore();
+    object_t::copy_restore();
+  }
+
+  void restore() noexcept(is_nothrow_restore) {
+    base_t::restore();
+    object_t::restore();
+  }
+};
+
+template <typename P>
+struct is_policy : std::integral_constant<bool, std::is_same<P, on_exit_policy>::value || std::is_same<P, on_fail_policy>::value || std::is_same<P, on_success_policy>::value> {};
+
+// Saved object is a base, so the policy is placed in its tail padding.
+template <typename U, typename P>
+class state_saver : private saved_object<U> {
+  using T = typename saved_object<U>::type;
+
+  static_assert(is_policy<P>::value,
+                "state_saver requires on_exit_policy, on_fail_policy or on_success_policy.");
+
+  P policy_;
 
  public:
   state_saver() = delete;
@@ -195,68 +400,479 @@ class state_saver {
   state_saver(T&&) = delete;
   state_saver(const T&) = delete;
 
-  explicit state_saver(T& object) noexcept(std::is_nothrow_constructible<T, T&>::value)
-      : policy_{true},
-        previous_ref_{object},
-        previous_value_{object} {}
+  explicit state_saver(T& object) noexcept(saved_object<U>::is_nothrow_constructible)
+      : saved_object<U>{object},
+        policy_{true} {}
+
+  // Saved copy is allocated by alloc, e.g. std::pmr::polymorphic_allocator of an arena. Restore assigns it back,
+  // so the object keeps its own allocator if the allocator does not propagate on assignment.
+  template <typename A, typename = typename std::enable_if<std::uses_allocator<T, A>::value>::type>
+  state_saver(T& object, const A& alloc) noexcept(noexcept(saved_object<U>{object, alloc}))
+      : saved_object<U>{object, alloc},
+        policy_{true} {}
 
   void dismiss() noexcept {
     policy_.dismiss();
   }
 
   template <typename O = T>
-  auto restore() NEARGYE_NOEXCEPT(std::is_nothrow_assignable<O&, O&>::value) -> typename std::enable_if<std::is_same<T, O>::value && std::is_assignable<O&, O&>::value>::type {
+  auto restore() NEARGYE_NOEXCEPT(saved_object<O>::is_nothrow_copy_assignable) -> typename std::enable_if<std::is_same<T, O>::value && std::is_assignable<O&, O&>::value>::type {
     static_assert(std::is_assignable<O&, O&>::value, "state_saver::restore requires copy operator=.");
 #if defined(STATE_SAVER_NO_THROW_RESTORE)
     static_assert(std::is_nothrow_assignable<O&, O&>::value, "state_saver::restore requires noexcept copy operator=.");
 #endif
     NEARGYE_TRY
-      previous_ref_ = previous_value_;
+      saved_object<U>::copy_restore();
     NEARGYE_CATCH
   }
 
-  ~state_saver() NEARGYE_NOEXCEPT(std::is_nothrow_assignable<T&, assignable_t>::value) {
+  ~state_saver() NEARGYE_NOEXCEPT(saved_object<U>::is_nothrow_restore) {
     if (policy_.should_execute()) {
       NEARGYE_TRY
-        previous_ref_ = static_cast<assignable_t>(previous_value_);
+        saved_object<U>::restore();
       NEARGYE_CATCH
     }
   }
 };
 
+// Saves several objects with one policy, restores them in reverse order.
+template <typename P, typename... U>
+class state_savers : private saved_objects<U...> {
+  static_assert(is_policy<P>::value,
+                "state_saver requires on_exit_policy, on_fail_policy or on_success_policy.");
+
+  P policy_;
+
+ public:
+  state_savers() = delete;
+  state_savers(const state_savers&) = delete;
+  state_savers(state_savers&&) = delete;
+  state_savers& operator=(const state_savers&) = delete;
+  state_savers& operator=(state_savers&&) = delete;
+
+  explicit state_savers(typename saved_object<U>::type&... objects) noexcept(saved_objects<U...>::is_nothrow_constructible)
+      : saved_objects<U...>{objects...},
+        policy_{true} {}
+
+  void dismiss() noexcept {
+    policy_.dismiss();
+  }
+
+  template <bool B = saved_objects<U...>::is_copy_assignable>
+  auto restore() NEARGYE_NOEXCEPT(saved_objects<U...>::is_nothrow_copy_assignable) -> typename std::enable_if<B>::type {
+#if defined(STATE_SAVER_NO_THROW_RESTORE)
+    static_assert(saved_objects<U...>::is_nothrow_copy_assignable, "state_saver::restore requires noexcept copy operator=.");
+#endif
+    NEARGYE_TRY
+      saved_objects<U...>::copy_restore();
+    NEARGYE_CATCH
+  }
+
+  ~state_savers() NEARGYE_NOEXCEPT(saved_objects<U...>::is_nothrow_restore) {
+    if (policy_.should_execute()) {
+      NEARGYE_TRY
+        saved_objects<U...>::restore();
+      NEARGYE_CATCH
+    }
+  }
+};
+
+// Saves the object on first access through get(), so nothing is copied if the object is never changed.
+template <typename U, typename P>
+class lazy_state_saver {
+  using T = typename saved_object<U>::type;
+
+  static_assert(is_policy<P>::value,
+                "state_saver requires on_exit_policy, on_fail_policy or on_success_policy.");
+
+  T& object_;
+  saved_object<U>* saved_;
+  P policy_;
+  alignas(saved_object<U>) unsigned char storage_[sizeof(saved_object<U>)];
+
+ public:
+  lazy_state_saver() = delete;
+  lazy_state_saver(const lazy_state_saver&) = delete;
+  lazy_state_saver(lazy_state_saver&&) = delete;
+  lazy_state_saver& operator=(const lazy_state_saver&) = delete;
+  lazy_state_saver& operator=(lazy_state_saver&&) = delete;
+
+  lazy_state_saver(T&&) = delete;
+  lazy_state_saver(const T&) = delete;
+
+  explicit lazy_state_saver(T& object) noexcept
+      : object_{object},
+        saved_{nullptr},
+        policy_{true} {}
+
+  void dismiss() noexcept {
+    policy_.dismiss();
+  }
+
+  // Write access, saves the object before first change.
+  T& get() noexcept(saved_object<U>::is_nothrow_constructible) {
+    if (saved_ == nullptr) {
+      saved_ = ::new (static_cast<void*>(storage_)) saved_object<U>{object_};
+    }
+    return object_;
+  }
+
+  // Read access, does not save the object.
+  const T& cget() const noexcept {
+    return object_;
+  }
+
+  bool is_saved() const noexcept {
+    return saved_ != nullptr;
+  }
+
+  template <typename O = T>
+  auto restore() NEARGYE_NOEXCEPT(saved_object<O>::is_nothrow_copy_assignable) -> typename std::enable_if<std::is_same<T, O>::value && std::is_assignable<O&, O&>::value>::type {
+    static_assert(std::is_assignable<O&, O&>::value, "state_saver::restore requires copy operator=.");
+#if defined(STATE_SAVER_NO_THROW_RESTORE)
+    static_assert(std::is_nothrow_assignable<O&, O&>::value, "state_saver::restore requires noexcept copy operator=.");
+#endif
+    if (saved_ != nullptr) {
+      NEARGYE_TRY
+        saved_->copy_restore();
+      NEARGYE_CATCH
+    }
+  }
+
+  ~lazy_state_saver() NEARGYE_NOEXCEPT(saved_object<U>::is_nothrow_restore) {
+    if (saved_ != nullptr) {
+      if (policy_.should_execute()) {
+        NEARGYE_TRY
+          saved_->restore();
+        NEARGYE_CATCH
+      }
+      saved_->~saved_object();
+    }
+  }
+};
+
+namespace swap_adl {
+
+using std::swap;
+
+template <typename T>
+struct is_nothrow_swappable : std::integral_constant<bool, noexcept(swap(std::declval<T&>(), std::declval<T&>()))> {};
+
+template <typename T>
+void swap_objects(T& a, T& b) noexcept(is_nothrow_swappable<T>::value) {
+  swap(a, b);
+}
+
+} // namespace state_saver::detail::swap_adl
+
+// Moves the object out instead of copying it, the object is left with a replacement value.
+template <typename U, typename P>
+class swap_state_saver {
+  using T = typename std::remove_reference<U>::type;
+
+  static_assert(is_policy<P>::value,
+                "state_saver requires on_exit_policy, on_fail_policy or on_success_policy.");
+  static_assert(!std::is_const<T>::value,
+                "state_saver requires not const type.");
+  static_assert(!std::is_rvalue_reference<U>::value && (std::is_lvalue_reference<U>::value || std::is_same<T, U>::value),
+                "state_saver requires lvalue type.");
+  static_assert(!std::is_array<T>::value,
+                "state_saver requires not array type.");
+  static_assert(std::is_move_constructible<T>::value && std::is_move_assignable<T>::value,
+                "swap_saver requires move constructible and move assignable.");
+#if defined(STATE_SAVER_NO_THROW_RESTORE)
+  static_assert(std::is_nothrow_move_assignable<T>::value,
+                "state_saver requires noexcept operator=.");
+#endif
+
+  T& object_;
+  T previous_value_;
+  P policy_;
+
+ public:
+  swap_state_saver() = delete;
+  swap_state_saver(const swap_state_saver&) = delete;
+  swap_state_saver(swap_state_saver&&) = delete;
+  swap_state_saver& operator=(const swap_state_saver&) = delete;
+  swap_state_saver& operator=(swap_state_saver&&) = delete;
+
+  swap_state_saver(T&&) = delete;
+  swap_state_saver(const T&) = delete;
+
+  // The object is left value-initialized.
+  explicit swap_state_saver(T& object) noexcept(std::is_nothrow_default_constructible<T>::value && swap_adl::is_nothrow_swappable<T>::value)
+      : object_{object},
+        previous_value_{},
+        policy_{true} {
+    swap_adl::swap_objects(object_, previous_value_);
+  }
+
+  // The object is left with replacement.
+  swap_state_saver(T& object, T replacement) noexcept(std::is_nothrow_move_constructible<T>::value && swap_adl::is_nothrow_swappable<T>::value)
+      : object_{object},
+        previous_value_{std::move(replacement)},
+        policy_{true} {
+    swap_adl::swap_objects(object_, previous_value_);
+  }
+
+  void dismiss() noexcept {
+    policy_.dismiss();
+  }
+
+  // Moves the saved value back, the saver is dismissed since the saved value is consumed.
+  void restore() NEARGYE_NOEXCEPT(std::is_nothrow_move_assignable<T>::value) {
+    NEARGYE_TRY
+      object_ = std::move(previous_value_);
+      policy_.dismiss();
+    NEARGYE_CATCH
+  }
+
+  ~swap_state_saver() NEARGYE_NOEXCEPT(std::is_nothrow_move_assignable<T>::value) {
+    if (policy_.should_execute()) {
+      NEARGYE_TRY
+        object_ = std::move(previous_value_);
+      NEARGYE_CATCH
+    }
+  }
+};
+
+template <typename S, typename = void>
+struct has_status_value : std::false_type {};
+
+template <typename S>
+struct has_status_value<S, typename std::enable_if<std::is_convertible<decltype(std::declval<const S&>().has_value()), bool>::value>::type> : std::true_type {};
+
+template <typename S, typename = void>
+struct has_status_category : std::false_type {};
+
+template <typename S>
+struct has_status_category<S, typename std::enable_if<!std::is_void<decltype(std::declval<const S&>().category())>::value>::type> : std::true_type {};
+
+// Expected-like (has_value()) fails without a value, error_code-like (category()) fails if set, bool-like fails if false.
+template <typename S, int = has_status_value<S>::value ? 2 : (has_status_category<S>::value ? 1 : 0)>
+struct status_failure {
+  static bool failed(const S& status) noexcept {
+    return !static_cast<bool>(status);
+  }
+};
+
+template <typename S>
+struct status_failure<S, 1> {
+  static bool failed(const S& status) noexcept {
+    return static_cast<bool>(status);
+  }
+};
+
+template <typename S>
+struct status_failure<S, 2> {
+  static bool failed(const S& status) noexcept {
+    return !status.has_value();
+  }
+};
+
+// Executes if the observed status reports failure (OnFail) or success (!OnFail) on scope exit, without exceptions.
+template <typename S, bool OnFail>
+class on_status_policy {
+  const S* status_;
+
+ public:
+  explicit on_status_policy(const S& status) noexcept : status_{std::addressof(status)} {}
+
+  void dismiss() noexcept {
+    status_ = nullptr;
+  }
+
+  bool should_execute() const noexcept {
+    return status_ != nullptr && static_cast<bool>(status_traits<S>::failed(*status_)) == OnFail;
+  }
+};
+
+// Saved object is a base, so the policy is placed in its tail padding.
+template <typename U, typename S, bool OnFail>
+class status_state_saver : private saved_object<U> {
+  using T = typename saved_object<U>::type;
+
+  static_assert(!std::is_reference<S>::value && !std::is_const<S>::value,
+                "status_saver requires not reference, not const status type.");
+
+  on_status_policy<S, OnFail> policy_;
+
+ public:
+  status_state_saver() = delete;
+  status_state_saver(const status_state_saver&) = delete;
+  status_state_saver(status_state_saver&&) = delete;
+  status_state_saver& operator=(const status_state_saver&) = delete;
+  status_state_saver& operator=(status_state_saver&&) = delete;
+
+  status_state_saver(T&&, const S&) = delete;
+  status_state_saver(const T&, const S&) = delete;
+  status_state_saver(T&, const S&&) = delete;
+
+  // status is observed on scope exit, it must outlive the saver.
+  status_state_saver(T& object, const S& status) noexcept(saved_object<U>::is_nothrow_constructible)
+      : saved_object<U>{object},
+        policy_{status} {}
+
+  void dismiss() noexcept {
+    policy_.dismiss();
+  }
+
+  template <typename O = T>
+  auto restore() NEARGYE_NOEXCEPT(saved_object<O>::is_nothrow_copy_assignable) -> typename std::enable_if<std::is_same<T, O>::value && std::is_assignable<O&, O&>::value>::type {
+    static_assert(std::is_assignable<O&, O&>::value, "state_saver::restore requires copy operator=.");
+#if defined(STATE_SAVER_NO_THROW_RESTORE)
+    static_assert(std::is_nothrow_assignable<O&, O&>::value, "state_saver::restore requires noexcept copy operator=.");
+#endif
+    NEARGYE_TRY
+      saved_object<U>::copy_restore();
+    NEARGYE_CATCH
+  }
+
+  ~status_state_saver() NEARGYE_NOEXCEPT(saved_object<U>::is_nothrow_restore) {
+    if (policy_.should_execute()) {
+      NEARGYE_TRY
+        saved_object<U>::restore();
+      NEARGYE_CATCH
+    }
+  }
+};
+
+template <typename P, typename... U>
+struct select_state_saver {
+  using type = state_savers<P, U...>;
+};
+
+template <typename P, typename U>
+struct select_state_saver<P, U> {
+  using type = state_saver<U, P>;
+};
+
+template <template <typename...> class S, typename... U>
+S<U...> make_saver_type(U&...) noexcept;
+
 #undef NEARGYE_NOEXCEPT
 #undef NEARGYE_TRY
 #undef NEARGYE_CATCH
 
 } // namespace state_saver::detail
 
+template <typename S>
+struct status_traits : detail::status_failure<S> {};
+
+template <typename... U>
+class saver_exit : public detail::select_state_saver<detail::on_exit_policy, U...>::type {
+  using base_t = typename detail::select_state_saver<detail::on_exit_policy, U...>::type;
+
+ public:
+  using base_t::base_t;
+};
+
+template <typename... U>
+class saver_fail : public detail::select_state_saver<detail::on_fail_policy, U...>::type {
+  using base_t = typename detail::select_state_saver<detail::on_fail_policy, U...>::type;
+
+ public:
+  using base_t::base_t;
+};
+
+template <typename... U>
+class saver_success : public detail::select_state_saver<detail::on_success_policy, U...>::type {
+  using base_t = typename detail::select_state_saver<detail::on_success_policy, U...>::type;
+
+ public:
+  using base_t::base_t;
+};
+
 template <typename U>
-class saver_exit : public detail::state_saver<U, detail::on_exit_policy> {
+class lazy_saver_exit : public detail::lazy_state_saver<U, detail::on_exit_policy> {
  public:
-  using detail::state_saver<U, detail::on_exit_policy>::state_saver;
+  using detail::lazy_state_saver<U, detail::on_exit_policy>::lazy_state_saver;
 };
 
 template <typename U>
-class saver_fail : public detail::state_saver<U, detail::on_fail_policy> {
+class lazy_saver_fail : public detail::lazy_state_saver<U, detail::on_fail_policy> {
  public:
-  using detail::state_saver<U, detail::on_fail_policy>::state_saver;
+  using detail::lazy_state_saver<U, detail::on_fail_policy>::lazy_state_saver;
 };
 
 template <typename U>
-class saver_success : public detail::state_saver<U, detail::on_success_policy> {
+class lazy_saver_success : public detail::lazy_state_saver<U, detail::on_success_policy> {
  public:
-  using detail::state_saver<U, detail::on_success_policy>::state_saver;
+  using detail::lazy_state_saver<U, detail::on_success_policy>::lazy_state_saver;
+};
+
+template <typename U>
+class swap_saver_exit : public detail::swap_state_saver<U, detail::on_exit_policy> {
+ public:
+  using detail::swap_state_saver<U, detail::on_exit_policy>::swap_state_saver;
+};
+
+template <typename U>
+class swap_saver_fail : public detail::swap_state_saver<U, detail::on_fail_policy> {
+ public:
+  using detail::swap_state_saver<U, detail::on_fail_policy>::swap_state_saver;
+};
+
+template <typename U>
+class swap_saver_success : public detail::swap_state_saver<U, detail::on_success_policy> {
+ public:
+  using detail::swap_state_saver<U, detail::on_success_policy>::swap_state_saver;
+};
+
+template <typename U, typename S>
+class status_saver_fail : public detail::status_state_saver<U, S, true> {
+ public:
+  using detail::status_state_saver<U, S, true>::status_state_saver;
+};
+
+template <typename U, typename S>
+class status_saver_success : public detail::status_state_saver<U, S, false> {
+ public:
+  using detail::status_state_saver<U, S, false>::status_state_saver;
 };
 
 #if defined(__cpp_deduction_guides) && __cpp_deduction_guides >= 201611L
+template <typename... U>
+saver_exit(U&...) -> saver_exit<U...>;
+
+template <typename... U>
+saver_fail(U&...) -> saver_fail<U...>;
+
+template <typename... U>
+saver_success(U&...) -> saver_success<U...>;
+
+template <typename U>
+lazy_saver_exit(U&) -> lazy_saver_exit<U>;
+
+template <typename U>
+lazy_saver_fail(U&) -> lazy_saver_fail<U>;
+
+template <typename U>
+lazy_saver_success(U&) -> lazy_saver_success<U>;
+
 template <typename U>
-saver_exit(U&) -> saver_exit<U>;
+swap_saver_exit(U&) -> swap_saver_exit<U>;
 
 template <typename U>
-saver_fail(U&) -> saver_fail<U>;
+swap_saver_exit(U&, U) -> swap_saver_exit<U>;
 
 template <typename U>
-saver_success(U&) -> saver_success<U>;
+swap_saver_fail(U&) -> swap_saver_fail<U>;
+
+template <typename U>
+swap_saver_fail(U&, U) -> swap_saver_fail<U>;
+
+template <typename U>
+swap_saver_success(U&) -> swap_saver_success<U>;
+
+template <typename U>
+swap_saver_success(U&, U) -> swap_saver_success<U>;
+
+template <typename U, typename S>
+status_saver_fail(U&, const S&) -> status_saver_fail<U, S>;
+
+template <typename U, typename S>
+status_saver_success(U&, const S&) -> status_saver_success<U, S>;
 #endif
 
 } // namespace state_saver
@@ -299,22 +915,24 @@ saver_success(U&) -> saver_success<U>;
 #  endif
 #endif
 
-#define NEARGYE_STATE_SAVER_WITH_(s, i) for (int i = 1; i--; s)
-#define NEARGYE_STATE_SAVER_WITH(s)     NEARGYE_STATE_SAVER_WITH_(s, NEARGYE_STR_CONCAT(NEARGYE_INTERNAL_OBJECT_, NEARGYE_COUNTER))
+#define NEARGYE_STATE_SAVER_WITH_(i, ...) for (int i = 1; i--; __VA_ARGS__)
+#define NEARGYE_STATE_SAVER_WITH(...)     NEARGYE_STATE_SAVER_WITH_(NEARGYE_STR_CONCAT(NEARGYE_INTERNAL_OBJECT_, NEARGYE_COUNTER), __VA_ARGS__)
+
+#define NEARGYE_STATE_SAVER_TYPE(s, ...) decltype(::state_saver::detail::make_saver_type<::state_saver::s>(__VA_ARGS__))
 
-// SAVER_EXIT saves the original variable value and restores on scope exit.
-#define MAKE_SAVER_EXIT(name, x) ::state_saver::saver_exit<decltype(x)> name{x}
-#define SAVER_EXIT(x)            NEARGYE_MAYBE_UNUSED const MAKE_SAVER_EXIT(NEARGYE_STR_CONCAT(SAVER_EXIT_, NEARGYE_COUNTER), x)
-#define WITH_SAVER_EXIT(x)       NEARGYE_STATE_SAVER_WITH(::state_saver::saver_exit<decltype(x)>{x})
+// SAVER_EXIT saves the original variables values and restores on scope exit.
+#define MAKE_SAVER_EXIT(name, ...) NEARGYE_STATE_SAVER_TYPE(saver_exit, __VA_ARGS__) name{__VA_ARGS__}
+#define SAVER_EXIT(...)            NEARGYE_MAYBE_UNUSED const MAKE_SAVER_EXIT(NEARGYE_STR_CONCAT(SAVER_EXIT_, NEARGYE_COUNTER), __VA_ARGS__)
+#define WITH_SAVER_EXIT(...)       NEARGYE_STATE_SAVER_WITH(NEARGYE_STATE_SAVER_TYPE(saver_exit, __VA_ARGS__){__VA_ARGS__})
 
-// SAVER_FAIL saves the original variable value and restores on scope exit when an exception has been thrown.
-#define MAKE_SAVER_FAIL(name, x) ::state_saver::saver_fail<decltype(x)> name{x}
-#define SAVER_FAIL(x)            NEARGYE_MAYBE_UNUSED const MAKE_SAVER_FAIL(NEARGYE_STR_CONCAT(SAVER_FAIL_, NEARGYE_COUNTER), x)
-#define WITH_SAVER_FAIL(x)       NEARGYE_STATE_SAVER_WITH(::state_saver::saver_fail<decltype(x)>{x})
+// SAVER_FAIL saves the original variables values and restores on scope exit when an exception has been thrown.
+#define MAKE_SAVER_FAIL(name, ...) NEARGYE_STATE_SAVER_TYPE(saver_fail, __VA_ARGS__) name{__VA_ARGS__}
+#define SAVER_FAIL(...)            NEARGYE_MAYBE_UNUSED const MAKE_SAVER_FAIL(NEARGYE_STR_CONCAT(SAVER_FAIL_, NEARGYE_COUNTER), __VA_ARGS__)
+#define WITH_SAVER_FAIL(...)       NEARGYE_STATE_SAVER_WITH(NEARGYE_STATE_SAVER_TYPE(saver_fail, __VA_ARGS__){__VA_ARGS__})
 
-// SAVER_SUCCESS saves the original variable value and restores on scope exit when no exceptions have been thrown.
-#define MAKE_SAVER_SUCCESS(name, x) ::state_saver::saver_success<decltype(x)> name{x}
-#define SAVER_SUCCESS(x)            NEARGYE_MAYBE_UNUSED const MAKE_SAVER_SUCCESS(NEARGYE_STR_CONCAT(SAVER_SUCCES_, NEARGYE_COUNTER), x)
-#define WITH_SAVER_SUCCESS(x)       NEARGYE_STATE_SAVER_WITH(::state_saver::saver_success<decltype(x)>{x})
+// SAVER_SUCCESS saves the original variables values and restores on scope exit when no exceptions have been thrown.
+#define MAKE_SAVER_SUCCESS(name, ...) NEARGYE_STATE_SAVER_TYPE(saver_success, __VA_ARGS__) name{__VA_ARGS__}
+#define SAVER_SUCCESS(...)            NEARGYE_MAYBE_UNUSED const MAKE_SAVER_SUCCESS(NEARGYE_STR_CONCAT(SAVER_SUCCES_, NEARGYE_COUNTER), __VA_ARGS__)
+#define WITH_SAVER_SUCCESS(...)       NEARGYE_STATE_SAVER_WITH(NEARGYE_STATE_SAVER_TYPE(saver_success, __VA_ARGS__){__VA_ARGS__})
 
 #endif // NEARGYE_STATE_SAVER_HPP
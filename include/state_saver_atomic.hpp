@@ -0,0 +1,328 @@
+//   _____ _        _          _____                         _____
+//  / ____| |      | |        / ____|                       / ____|_     _
+// | (___ | |_ __ _| |_ ___  | (___   __ ___   _____ _ __  | |   _| |_ _| |_
+//  \___ \| __/ _` | __/ _ \  \___ \ / _` \ \ / / _ \ '__| | |  |_   _|_   _|
+//  ____) | || (_| | ||  __/  ____) | (_| |\ V /  __/ |    | |____|_|   |_|
+// |_____/ \__\__,_|\__\___| |_____/ \__,_| \_/ \___|_|     \_____|
+// https://github.com/Neargye/state_saver
+// version 0.9.1
+//
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2018 - 2021 Daniil Goncharov <neargye@gmail.com>.
+//
+// Permission is hereby  granted, free of charge, to any  person obtaining a copy
+// of this software and associated  documentation files (the "Software"), to deal
+// in the Software  without restriction, including without  limitation the rights
+// to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+// copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef NEARGYE_STATE_SAVER_ATOMIC_HPP
+#define NEARGYE_STATE_SAVER_ATOMIC_HPP
+
+#include "state_saver.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+
+// Atomic savers save std::atomic<T> with a load and restore it with a store, or with a compare-exchange which restores
+// only if nobody else has changed the value set through the saver. Savers of std::atomic<T> (SAVER_EXIT(flag), ...)
+// use them once this header is included.
+// Seqlock savers save a seqlock<T> and restore it with one publish, concurrent readers retry instead of seeing torn values.
+
+namespace state_saver {
+
+enum class atomic_restore {
+  // Restores with store.
+  store,
+  // Restores with compare-exchange, only if the value is still the one set through the saver (or the saved one).
+  compare_exchange
+};
+
+// Trivially copyable value shared with concurrent readers, which never block: load() retries while a store is in progress.
+// Stores of several writers are serialized. The value is kept in atomic words, so copies are free of data races.
+template <typename T>
+class seqlock {
+  static_assert(std::is_trivially_copyable<T>::value && std::is_default_constructible<T>::value,
+                "seqlock requires trivially copyable and default constructible type.");
+
+  using word = std::uintptr_t;
+
+  static constexpr std::size_t words = (sizeof(T) + sizeof(word) - 1) / sizeof(word);
+
+  // Odd while a store is in progress.
+  std::atomic<std::size_t> sequence_;
+  std::atomic<word> data_[words];
+
+  void write(const T& value) noexcept {
+    word buffer[words] = {};
+    std::memcpy(buffer, std::addressof(value), sizeof(T));
+    for (std::size_t i = 0; i < words; ++i) {
+      data_[i].store(buffer[i], std::memory_order_relaxed);
+    }
+  }
+
+ public:
+  seqlock() noexcept : seqlock{T{}} {}
+
+  explicit seqlock(const T& value) noexcept : sequence_{0} {
+    write(value);
+  }
+
+  seqlock(const seqlock&) = delete;
+  seqlock& operator=(const seqlock&) = delete;
+
+  T load() const noexcept {
+    word buffer[words];
+    for (;;) {
+      const std::size_t before = sequence_.load(std::memory_order_acquire);
+      for (std::size_t i = 0; i < words; ++i) {
+        buffer[i] = data_[i].load(std::memory_order_relaxed);
+      }
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if ((before & 1) == 0 && sequence_.load(std::memory_order_relaxed) == before) {
+        break;
+      }
+    }
+
+    T value;
+    std::memcpy(std::addressof(value), buffer, sizeof(T));
+    return value;
+  }
+
+  void store(const T& value) noexcept {
+    std::size_t sequence = sequence_.load(std::memory_order_relaxed);
+    // Acquire on success orders this store after the previous writer's, whose release store made the sequence even.
+    while ((sequence & 1) != 0 || !sequence_.compare_exchange_weak(sequence, sequence + 1, std::memory_order_acquire, std::memory_order_relaxed)) {
+      sequence = sequence_.load(std::memory_order_relaxed);
+    }
+    std::atomic_thread_fence(std::memory_order_release);
+    write(value);
+    sequence_.store(sequence + 2, std::memory_order_release);
+  }
+
+  // Number of completed stores times two.
+  std::size_t sequence() const noexcept {
+    return sequence_.load(std::memory_order_acquire);
+  }
+};
+
+namespace detail {
+
+// Load part of an order, as for the failure order of compare-exchange.
+constexpr std::memory_order atomic_load_order(std::memory_order order) noexcept {
+  return order == std::memory_order_release ? std::memory_order_relaxed : (order == std::memory_order_acq_rel ? std::memory_order_acquire : order);
+}
+
+// Store part of an order.
+constexpr std::memory_order atomic_store_order(std::memory_order order) noexcept {
+  return (order == std::memory_order_acquire || order == std::memory_order_consume) ? std::memory_order_relaxed : (order == std::memory_order_acq_rel ? std::memory_order_release : order);
+}
+
+template <typename T, typename P, atomic_restore R>
+class atomic_state_saver {
+  static_assert(is_policy<P>::value,
+                "state_saver requires on_exit_policy, on_fail_policy or on_success_policy.");
+
+  std::atomic<T>& object_;
+  T previous_value_;
+  T expected_;
+  std::memory_order order_;
+  P policy_;
+
+  void restore_value(std::integral_constant<atomic_restore, atomic_restore::store>) noexcept {
+    object_.store(previous_value_, atomic_store_order(order_));
+  }
+
+  void restore_value(std::integral_constant<atomic_restore, atomic_restore::compare_exchange>) noexcept {
+    T expected = expected_;
+    object_.compare_exchange_strong(expected, previous_value_, order_, atomic_load_order(order_));
+  }
+
+ public:
+  atomic_state_saver() = delete;
+  atomic_state_saver(const atomic_state_saver&) = delete;
+  atomic_state_saver(atomic_state_saver&&) = delete;
+  atomic_state_saver& operator=(const atomic_state_saver&) = delete;
+  atomic_state_saver& operator=(atomic_state_saver&&) = delete;
+
+  // Saves the value with a load.
+  explicit atomic_state_saver(std::atomic<T>& object, std::memory_order order = std::memory_order_seq_cst) noexcept
+      : object_{object},
+        previous_value_{object.load(atomic_load_order(order))},
+        expected_{previous_value_},
+        order_{order},
+        policy_{true} {}
+
+  // Saves the value and sets value with one exchange.
+  atomic_state_saver(std::atomic<T>& object, T value, std::memory_order order = std::memory_order_seq_cst) noexcept
+      : object_{object},
+        previous_value_{object.exchange(value, order)},
+        expected_{value},
+        order_{order},
+        policy_{true} {}
+
+  void dismiss() noexcept {
+    policy_.dismiss();
+  }
+
+  // Sets value, a compare-exchange restore expects it.
+  void store(T value) noexcept {
+    object_.store(value, atomic_store_order(order_));
+    expected_ = value;
+  }
+
+  T saved() const noexcept {
+    return previous_value_;
+  }
+
+  void restore() noexcept {
+    restore_value(std::integral_constant<atomic_restore, R>{});
+    expected_ = previous_value_;
+  }
+
+  ~atomic_state_saver() {
+    if (policy_.should_execute()) {
+      restore_value(std::integral_constant<atomic_restore, R>{});
+    }
+  }
+};
+
+// Restores with one store, concurrent readers see either the changed value or the saved one.
+template <typename T, typename P>
+class seqlock_state_saver {
+  static_assert(is_policy<P>::value,
+                "state_saver requires on_exit_policy, on_fail_policy or on_success_policy.");
+
+  seqlock<T>& object_;
+  T previous_value_;
+  P policy_;
+
+ public:
+  seqlock_state_saver() = delete;
+  seqlock_state_saver(const seqlock_state_saver&) = delete;
+  seqlock_state_saver(seqlock_state_saver&&) = delete;
+  seqlock_state_saver& operator=(const seqlock_state_saver&) = delete;
+  seqlock_state_saver& operator=(seqlock_state_saver&&) = delete;
+
+  explicit seqlock_state_saver(seqlock<T>& object) noexcept
+      : object_{object},
+        previous_value_(object.load()),
+        policy_{true} {}
+
+  void dismiss() noexcept {
+    policy_.dismiss();
+  }
+
+  const T& saved() const noexcept {
+    return previous_value_;
+  }
+
+  void restore() noexcept {
+    object_.store(previous_value_);
+  }
+
+  ~seqlock_state_saver() {
+    if (policy_.should_execute()) {
+      object_.store(previous_value_);
+    }
+  }
+};
+
+template <typename P, typename T>
+struct select_state_saver<P, std::atomic<T>> {
+  using type = atomic_state_saver<T, P, atomic_restore::store>;
+};
+
+template <typename P, typename T>
+struct select_state_saver<P, std::atomic<T>&> {
+  using type = atomic_state_saver<T, P, atomic_restore::store>;
+};
+
+template <typename P, typename T>
+struct select_state_saver<P, seqlock<T>> {
+  using type = seqlock_state_saver<T, P>;
+};
+
+template <typename P, typename T>
+struct select_state_saver<P, seqlock<T>&> {
+  using type = seqlock_state_saver<T, P>;
+};
+
+} // namespace state_saver::detail
+
+template <typename T, atomic_restore R = atomic_restore::store>
+class atomic_saver_exit : public detail::atomic_state_saver<T, detail::on_exit_policy, R> {
+ public:
+  using detail::atomic_state_saver<T, detail::on_exit_policy, R>::atomic_state_saver;
+};
+
+template <typename T, atomic_restore R = atomic_restore::store>
+class atomic_saver_fail : public detail::atomic_state_saver<T, detail::on_fail_policy, R> {
+ public:
+  using detail::atomic_state_saver<T, detail::on_fail_policy, R>::atomic_state_saver;
+};
+
+template <typename T, atomic_restore R = atomic_restore::store>
+class atomic_saver_success : public detail::atomic_state_saver<T, detail::on_success_policy, R> {
+ public:
+  using detail::atomic_state_saver<T, detail::on_success_policy, R>::atomic_state_saver;
+};
+
+template <typename T>
+class seqlock_saver_exit : public detail::seqlock_state_saver<T, detail::on_exit_policy> {
+ public:
+  using detail::seqlock_state_saver<T, detail::on_exit_policy>::seqlock_state_saver;
+};
+
+template <typename T>
+class seqlock_saver_fail : public detail::seqlock_state_saver<T, detail::on_fail_policy> {
+ public:
+  using detail::seqlock_state_saver<T, detail::on_fail_policy>::seqlock_state_saver;
+};
+
+template <typename T>
+class seqlock_saver_success : public detail::seqlock_state_saver<T, detail::on_success_policy> {
+ public:
+  using detail::seqlock_state_saver<T, detail::on_success_policy>::seqlock_state_saver;
+};
+
+#if defined(__cpp_deduction_guides) && __cpp_deduction_guides >= 201611L
+template <typename T, typename... A>
+atomic_saver_exit(std::atomic<T>&, A...) -> atomic_saver_exit<T>;
+
+template <typename T, typename... A>
+atomic_saver_fail(std::atomic<T>&, A...) -> atomic_saver_fail<T>;
+
+template <typename T, typename... A>
+atomic_saver_success(std::atomic<T>&, A...) -> atomic_saver_success<T>;
+
+template <typename T>
+seqlock_saver_exit(seqlock<T>&) -> seqlock_saver_exit<T>;
+
+template <typename T>
+seqlock_saver_fail(seqlock<T>&) -> seqlock_saver_fail<T>;
+
+template <typename T>
+seqlock_saver_success(seqlock<T>&) -> seqlock_saver_success<T>;
+#endif
+
+} // namespace state_saver
+
+#endif // NEARGYE_STATE_SAVER_ATOMIC_HPP
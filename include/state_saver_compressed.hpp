@@ -0,0 +1,304 @@
+//   _____ _        _          _____                         _____
+//  / ____| |      | |        / ____|                       / ____|_     _
+// | (___ | |_ __ _| |_ ___  | (___   __ ___   _____ _ __  | |   _| |_ _| |_
+//  \___ \| __/ _` | __/ _ \  \___ \ / _` \ \ / / _ \ '__| | |  |_   _|_   _|
+//  ____) | || (_| | ||  __/  ____) | (_| |\ V /  __/ |    | |____|_|   |_|
+// |_____/ \__\__,_|\__\___| |_____/ \__,_| \_/ \___|_|     \_____|
+// https://github.com/Neargye/state_saver
+// version 0.9.1
+//
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2018 - 2021 Daniil Goncharov <neargye@gmail.com>.
+//
+// Permission is hereby  granted, free of charge, to any  person obtaining a copy
+// of this software and associated  documentation files (the "Software"), to deal
+// in the Software  without restriction, including without  limitation the rights
+// to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+// copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef NEARGYE_STATE_SAVER_COMPRESSED_HPP
+#define NEARGYE_STATE_SAVER_COMPRESSED_HPP
+
+#include "state_saver.hpp"
+
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+// Compressed savers save a trivial standard-layout object (e.g. a large, mostly zero buffer) run-length encoded, and
+// decode it on restore, a class object into a temporary on the stack which is then assigned to it. They trade CPU time
+// on save and restore for memory.
+
+namespace state_saver {
+
+namespace detail {
+
+// Run-length encoding of bytes. Each block starts with a varint header (length << 1 | is_run) followed by the
+// repeated byte of a run, or by length literal bytes.
+class rle_snapshot {
+  static constexpr std::size_t min_run = 4;
+
+  std::vector<unsigned char> encoded_;
+  std::size_t size_;
+
+  // Counts encoded bytes.
+  struct size_sink {
+    std::size_t size = 0;
+
+    void put(unsigned char) noexcept {
+      ++size;
+    }
+
+    void put(const unsigned char*, std::size_t length) noexcept {
+      size += length;
+    }
+  };
+
+  // Writes encoded bytes into reserved memory.
+  struct vector_sink {
+    std::vector<unsigned char>& encoded;
+
+    void put(unsigned char c) {
+      encoded.push_back(c);
+    }
+
+    void put(const unsigned char* data, std::size_t length) {
+      encoded.insert(encoded.end(), data, data + length);
+    }
+  };
+
+  template <typename S>
+  static void put_header(S& sink, std::size_t length, bool run) {
+    std::size_t header = (length << 1) | static_cast<std::size_t>(run);
+    while (header >= 0x80) {
+      sink.put(static_cast<unsigned char>(header | 0x80));
+      header >>= 7;
+    }
+    sink.put(static_cast<unsigned char>(header));
+  }
+
+  template <typename S>
+  static void put_literal(S& sink, const unsigned char* data, std::size_t length) {
+    if (length != 0) {
+      put_header(sink, length, false);
+      sink.put(data, length);
+    }
+  }
+
+  template <typename S>
+  static void encode(S& sink, const unsigned char* data, std::size_t size) {
+    std::size_t literal = 0;
+    std::size_t i = 0;
+    while (i < size) {
+      std::size_t last = i + 1;
+      while (last < size && data[last] == data[i]) {
+        ++last;
+      }
+      if (last - i >= min_run) {
+        put_literal(sink, data + literal, i - literal);
+        put_header(sink, last - i, true);
+        sink.put(data[i]);
+        literal = last;
+      }
+      i = last;
+    }
+    put_literal(sink, data + literal, size - literal);
+  }
+
+  static std::size_t get_header(const unsigned char*& in) noexcept {
+    std::size_t header = 0;
+    for (unsigned shift = 0;; shift += 7) {
+      const unsigned char c = *in++;
+      header |= static_cast<std::size_t>(c & 0x7F) << shift;
+      if ((c & 0x80) == 0) {
+        return header;
+      }
+    }
+  }
+
+  // Calls run(offset, length, byte) and literal(offset, length, bytes) for each block, stops if one returns false.
+  template <typename R, typename L>
+  bool for_each_block(R&& run, L&& literal) const noexcept {
+    const unsigned char* in = encoded_.data();
+    const unsigned char* const end = in + encoded_.size();
+    std::size_t offset = 0;
+    while (in != end) {
+      const std::size_t header = get_header(in);
+      const std::size_t length = header >> 1;
+      if ((header & 1) != 0) {
+        if (!run(offset, length, *in++)) {
+          return false;
+        }
+      } else {
+        if (!literal(offset, length, in)) {
+          return false;
+        }
+        in += length;
+      }
+      offset += length;
+    }
+    return true;
+  }
+
+ public:
+  // Encodes in two passes, the first one computes the encoded size, so only that much memory is allocated.
+  // May throw std::bad_alloc.
+  rle_snapshot(const unsigned char* data, std::size_t size) : size_{size} {
+    size_sink counter;
+    encode(counter, data, size);
+    encoded_.reserve(counter.size);
+    vector_sink writer{encoded_};
+    encode(writer, data, size);
+  }
+
+  std::size_t size() const noexcept {
+    return size_;
+  }
+
+  std::size_t encoded_size() const noexcept {
+    return encoded_.size();
+  }
+
+  bool equal(const unsigned char* data) const noexcept {
+    return for_each_block(
+        [data](std::size_t offset, std::size_t length, unsigned char c) {
+          for (std::size_t i = offset; i < offset + length; ++i) {
+            if (data[i] != c) {
+              return false;
+            }
+          }
+          return true;
+        },
+        [data](std::size_t offset, std::size_t length, const unsigned char* bytes) {
+          return std::memcmp(data + offset, bytes, length) == 0;
+        });
+  }
+
+  void decode(unsigned char* data) const noexcept {
+    for_each_block(
+        [data](std::size_t offset, std::size_t length, unsigned char c) {
+          std::memset(data + offset, c, length);
+          return true;
+        },
+        [data](std::size_t offset, std::size_t length, const unsigned char* bytes) {
+          std::memcpy(data + offset, bytes, length);
+          return true;
+        });
+  }
+};
+
+template <typename T, typename P>
+class compressed_state_saver {
+  static_assert(is_trivially_restorable<T>::value && !std::is_const<T>::value,
+                "compressed_saver requires trivial standard-layout, not empty, not const, not volatile type.");
+  static_assert(is_policy<P>::value,
+                "compressed_saver requires on_exit_policy, on_fail_policy or on_success_policy.");
+
+  T& object_;
+  rle_snapshot previous_value_;
+  P policy_;
+
+  unsigned char* bytes() const noexcept {
+    return reinterpret_cast<unsigned char*>(std::addressof(object_));
+  }
+
+  // As snapshot<T, true>, trivial copy assignment, not decoding in place, keeps derived members in the tail padding of
+  // a base subobject.
+  void decode(std::true_type) noexcept {
+    T value;
+    previous_value_.decode(reinterpret_cast<unsigned char*>(std::addressof(value)));
+    object_ = value;
+  }
+
+  // Arrays and scalars have no tail padding reused by other objects.
+  void decode(std::false_type) noexcept {
+    previous_value_.decode(bytes());
+  }
+
+ public:
+  compressed_state_saver() = delete;
+  compressed_state_saver(const compressed_state_saver&) = delete;
+  compressed_state_saver(compressed_state_saver&&) = delete;
+  compressed_state_saver& operator=(const compressed_state_saver&) = delete;
+  compressed_state_saver& operator=(compressed_state_saver&&) = delete;
+
+  compressed_state_saver(T&&) = delete;
+  compressed_state_saver(const T&) = delete;
+
+  // Encodes the object, may throw std::bad_alloc.
+  explicit compressed_state_saver(T& object) : object_{object}, previous_value_{bytes(), sizeof(T)}, policy_{true} {}
+
+  // Size of the encoded snapshot in bytes.
+  std::size_t compressed_size() const noexcept {
+    return previous_value_.encoded_size();
+  }
+
+  void dismiss() noexcept {
+    policy_.dismiss();
+  }
+
+  void restore() noexcept {
+#if defined(STATE_SAVER_COMPARE_BEFORE_RESTORE)
+    if (previous_value_.equal(bytes())) {
+      return;
+    }
+#endif
+    decode(std::is_class<T>{});
+  }
+
+  ~compressed_state_saver() noexcept {
+    if (policy_.should_execute()) {
+      restore();
+    }
+  }
+};
+
+} // namespace state_saver::detail
+
+template <typename T>
+class compressed_saver_exit : public detail::compressed_state_saver<T, detail::on_exit_policy> {
+ public:
+  using detail::compressed_state_saver<T, detail::on_exit_policy>::compressed_state_saver;
+};
+
+template <typename T>
+class compressed_saver_fail : public detail::compressed_state_saver<T, detail::on_fail_policy> {
+ public:
+  using detail::compressed_state_saver<T, detail::on_fail_policy>::compressed_state_saver;
+};
+
+template <typename T>
+class compressed_saver_success : public detail::compressed_state_saver<T, detail::on_success_policy> {
+ public:
+  using detail::compressed_state_saver<T, detail::on_success_policy>::compressed_state_saver;
+};
+
+#if defined(__cpp_deduction_guides) && __cpp_deduction_guides >= 201611L
+template <typename T>
+compressed_saver_exit(T&) -> compressed_saver_exit<T>;
+
+template <typename T>
+compressed_saver_fail(T&) -> compressed_saver_fail<T>;
+
+template <typename T>
+compressed_saver_success(T&) -> compressed_saver_success<T>;
+#endif
+
+} // namespace state_saver
+
+#endif // NEARGYE_STATE_SAVER_COMPRESSED_HPP
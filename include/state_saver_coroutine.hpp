@@ -0,0 +1,279 @@
+//   _____ _        _          _____                         _____
+//  / ____| |      | |        / ____|                       / ____|_     _
+// | (___ | |_ __ _| |_ ___  | (___   __ ___   _____ _ __  | |   _| |_ _| |_
+//  \___ \| __/ _` | __/ _ \  \___ \ / _` \ \ / / _ \ '__| | |  |_   _|_   _|
+//  ____) | || (_| | ||  __/  ____) | (_| |\ V /  __/ |    | |____|_|   |_|
+// |_____/ \__\__,_|\__\___| |_____/ \__,_| \_/ \___|_|     \_____|
+// https://github.com/Neargye/state_saver
+// version 0.9.1
+//
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2018 - 2021 Daniil Goncharov <neargye@gmail.com>.
+//
+// Permission is hereby  granted, free of charge, to any  person obtaining a copy
+// of this software and associated  documentation files (the "Software"), to deal
+// in the Software  without restriction, including without  limitation the rights
+// to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+// copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef NEARGYE_STATE_SAVER_COROUTINE_HPP
+#define NEARGYE_STATE_SAVER_COROUTINE_HPP
+
+#include "state_saver.hpp"
+
+#if !defined(__cpp_impl_coroutine) || !defined(__has_include)
+#  error state_saver_coroutine.hpp requires C++20 coroutines.
+#elif !__has_include(<coroutine>)
+#  error state_saver_coroutine.hpp requires <coroutine>.
+#endif
+
+#include <coroutine>
+#include <type_traits>
+#include <utility>
+
+// Coroutine savers restore on failure or success of a coroutine body. saver_fail compares uncaught exceptions with the
+// count at its construction, which is wrong once the coroutine resumes in another context (another thread, a destructor
+// during unwinding). Coroutine savers compare with the count at the last resume, kept in the promise:
+// promise types derive from saver_promise_base, which wraps every co_await to record it, and savers find the promise
+// with co_await this_saver_promise. Awaiters of initial_suspend() and yield_value() are not passed through
+// await_transform, promise types return them wrapped by track_resume().
+
+namespace state_saver {
+
+class saver_promise_base;
+
+struct this_saver_promise_t {
+  explicit this_saver_promise_t() = default;
+};
+
+inline constexpr this_saver_promise_t this_saver_promise{};
+
+namespace detail {
+
+template <typename A, typename = void>
+struct has_member_co_await : std::false_type {};
+
+template <typename A>
+struct has_member_co_await<A, std::void_t<decltype(std::declval<A>().operator co_await())>> : std::true_type {};
+
+template <typename A, typename = void>
+struct has_free_co_await : std::false_type {};
+
+template <typename A>
+struct has_free_co_await<A, std::void_t<decltype(operator co_await(std::declval<A>()))>> : std::true_type {};
+
+template <typename A>
+decltype(auto) get_awaiter(A&& awaitable) {
+  if constexpr (has_member_co_await<A>::value) {
+    return std::forward<A>(awaitable).operator co_await();
+  } else if constexpr (has_free_co_await<A>::value) {
+    return operator co_await(std::forward<A>(awaitable));
+  } else {
+    return std::forward<A>(awaitable);
+  }
+}
+
+// Records the uncaught exceptions count of the resuming context.
+template <typename Awaiter>
+class resume_awaiter {
+  Awaiter awaiter_;
+  saver_promise_base& promise_;
+
+ public:
+  resume_awaiter(Awaiter&& awaiter, saver_promise_base& promise) : awaiter_(std::forward<Awaiter>(awaiter)), promise_{promise} {}
+
+  bool await_ready() noexcept(noexcept(std::declval<Awaiter&>().await_ready())) {
+    return awaiter_.await_ready();
+  }
+
+  template <typename Handle>
+  decltype(auto) await_suspend(Handle handle) noexcept(noexcept(std::declval<Awaiter&>().await_suspend(handle))) {
+    return awaiter_.await_suspend(handle);
+  }
+
+  decltype(auto) await_resume() noexcept(noexcept(std::declval<Awaiter&>().await_resume()));
+};
+
+} // namespace state_saver::detail
+
+class saver_promise_base {
+  template <typename>
+  friend class detail::resume_awaiter;
+
+  // The promise is constructed in the context which starts the body, if initial_suspend() does not suspend.
+  int resume_exceptions_ = detail::uncaught_exceptions();
+
+  class promise_awaiter {
+    saver_promise_base& promise_;
+
+   public:
+    explicit promise_awaiter(saver_promise_base& promise) noexcept : promise_{promise} {}
+
+    bool await_ready() const noexcept {
+      return true;
+    }
+
+    void await_suspend(std::coroutine_handle<>) const noexcept {}
+
+    saver_promise_base& await_resume() const noexcept {
+      return promise_;
+    }
+  };
+
+ public:
+  template <typename A>
+  auto await_transform(A&& awaitable) {
+    return track_resume(std::forward<A>(awaitable));
+  }
+
+  promise_awaiter await_transform(this_saver_promise_t) noexcept {
+    return promise_awaiter{*this};
+  }
+
+  // Wraps the awaiter of initial_suspend() or yield_value() to record the context of the resume after it, e.g.
+  // std::suspend_always initial_suspend() becomes auto initial_suspend() { return track_resume(std::suspend_always{}); }
+  template <typename A>
+  auto track_resume(A&& awaitable) {
+    // Lvalue awaiters are referenced, others are moved into the wrapper, which may outlive the full expression.
+    using result_t = decltype(detail::get_awaiter(std::forward<A>(awaitable)));
+    using awaiter_t = std::conditional_t<std::is_lvalue_reference_v<result_t>, result_t, std::remove_cvref_t<result_t>>;
+    return detail::resume_awaiter<awaiter_t>{detail::get_awaiter(std::forward<A>(awaitable)), *this};
+  }
+
+  // Records the context of a resume, for resumes not covered by co_await or track_resume().
+  void on_resume() noexcept {
+    resume_exceptions_ = detail::uncaught_exceptions();
+  }
+
+  // Uncaught exceptions count at the last resume.
+  int resume_exceptions() const noexcept {
+    return resume_exceptions_;
+  }
+};
+
+namespace detail {
+
+template <typename Awaiter>
+decltype(auto) resume_awaiter<Awaiter>::await_resume() noexcept(noexcept(std::declval<Awaiter&>().await_resume())) {
+  promise_.on_resume();
+  return awaiter_.await_resume();
+}
+
+#if defined(STATE_SAVER_SUPPRESS_THROW_RESTORE) && (defined(__cpp_exceptions) || defined(__EXCEPTIONS) || defined(_CPPUNWIND))
+#  define NEARGYE_NOEXCEPT(...) noexcept
+#  define NEARGYE_TRY           try {
+#  define NEARGYE_CATCH         } catch (...) { STATE_SAVER_CATCH_HANDLER }
+#else
+#  define NEARGYE_NOEXCEPT(...) noexcept(__VA_ARGS__)
+#  define NEARGYE_TRY
+#  define NEARGYE_CATCH
+#endif
+
+// Executes if the coroutine body is left by an exception (OnFail) or not (!OnFail).
+template <bool OnFail>
+class on_coroutine_policy {
+  const saver_promise_base* promise_;
+
+ public:
+  explicit on_coroutine_policy(const saver_promise_base& promise) noexcept : promise_{std::addressof(promise)} {}
+
+  void dismiss() noexcept {
+    promise_ = nullptr;
+  }
+
+  bool should_execute() const noexcept {
+    return promise_ != nullptr && (uncaught_exceptions() > promise_->resume_exceptions()) == OnFail;
+  }
+};
+
+template <typename U, bool OnFail>
+class coroutine_state_saver : private saved_object<U> {
+  using T = typename saved_object<U>::type;
+
+  on_coroutine_policy<OnFail> policy_;
+
+ public:
+  coroutine_state_saver() = delete;
+  coroutine_state_saver(const coroutine_state_saver&) = delete;
+  coroutine_state_saver(coroutine_state_saver&&) = delete;
+  coroutine_state_saver& operator=(const coroutine_state_saver&) = delete;
+  coroutine_state_saver& operator=(coroutine_state_saver&&) = delete;
+
+  coroutine_state_saver(T&&, saver_promise_base&) = delete;
+  coroutine_state_saver(const T&, saver_promise_base&) = delete;
+
+  coroutine_state_saver(T& object, saver_promise_base& promise) noexcept(saved_object<U>::is_nothrow_constructible)
+      : saved_object<U>{object},
+        policy_{promise} {}
+
+  void dismiss() noexcept {
+    policy_.dismiss();
+  }
+
+  template <typename O = T>
+  auto restore() NEARGYE_NOEXCEPT(saved_object<O>::is_nothrow_copy_assignable) -> std::enable_if_t<std::is_same_v<T, O> && std::is_assignable_v<O&, O&>> {
+#if defined(STATE_SAVER_NO_THROW_RESTORE)
+    static_assert(std::is_nothrow_assignable_v<O&, O&>, "state_saver::restore requires noexcept copy operator=.");
+#endif
+    NEARGYE_TRY
+      saved_object<U>::copy_restore();
+    NEARGYE_CATCH
+  }
+
+  ~coroutine_state_saver() NEARGYE_NOEXCEPT(noexcept(std::declval<saved_object<U>&>().restore())) {
+    if (policy_.should_execute()) {
+      NEARGYE_TRY
+        saved_object<U>::restore();
+      NEARGYE_CATCH
+    }
+  }
+};
+
+#undef NEARGYE_NOEXCEPT
+#undef NEARGYE_TRY
+#undef NEARGYE_CATCH
+
+} // namespace state_saver::detail
+
+template <typename U>
+class coroutine_saver_fail : public detail::coroutine_state_saver<U, true> {
+ public:
+  using detail::coroutine_state_saver<U, true>::coroutine_state_saver;
+};
+
+template <typename U>
+class coroutine_saver_success : public detail::coroutine_state_saver<U, false> {
+ public:
+  using detail::coroutine_state_saver<U, false>::coroutine_state_saver;
+};
+
+template <typename U>
+coroutine_saver_fail(U&, saver_promise_base&) -> coroutine_saver_fail<U>;
+
+template <typename U>
+coroutine_saver_success(U&, saver_promise_base&) -> coroutine_saver_success<U>;
+
+} // namespace state_saver
+
+// COROUTINE_SAVER_FAIL saves the original variable value and restores on scope exit when an exception leaves the coroutine scope.
+#define COROUTINE_SAVER_FAIL(object) \
+  NEARGYE_MAYBE_UNUSED const ::state_saver::coroutine_saver_fail<decltype(object)> NEARGYE_STR_CONCAT(COROUTINE_SAVER_FAIL_, NEARGYE_COUNTER){object, co_await ::state_saver::this_saver_promise}
+
+// COROUTINE_SAVER_SUCCESS saves the original variable value and restores on scope exit when no exception leaves the coroutine scope.
+#define COROUTINE_SAVER_SUCCESS(object) \
+  NEARGYE_MAYBE_UNUSED const ::state_saver::coroutine_saver_success<decltype(object)> NEARGYE_STR_CONCAT(COROUTINE_SAVER_SUCCESS_, NEARGYE_COUNTER){object, co_await ::state_saver::this_saver_promise}
+
+#endif // NEARGYE_STATE_SAVER_COROUTINE_HPP
@@ -0,0 +1,269 @@
+//   _____ _        _          _____                         _____
+//  / ____| |      | |        / ____|                       / ____|_     _
+// | (___ | |_ __ _| |_ ___  | (___   __ ___   _____ _ __  | |   _| |_ _| |_
+//  \___ \| __/ _` | __/ _ \  \___ \ / _` \ \ / / _ \ '__| | |  |_   _|_   _|
+//  ____) | || (_| | ||  __/  ____) | (_| |\ V /  __/ |    | |____|_|   |_|
+// |_____/ \__\__,_|\__\___| |_____/ \__,_| \_/ \___|_|     \_____|
+// https://github.com/Neargye/state_saver
+// version 0.9.1
+//
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2018 - 2021 Daniil Goncharov <neargye@gmail.com>.
+//
+// Permission is hereby  granted, free of charge, to any  person obtaining a copy
+// of this software and associated  documentation files (the "Software"), to deal
+// in the Software  without restriction, including without  limitation the rights
+// to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+// copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef NEARGYE_STATE_SAVER_DIFF_HPP
+#define NEARGYE_STATE_SAVER_DIFF_HPP
+
+#include "state_saver.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if !defined(STATE_SAVER_NO_SIMD)
+#  if defined(__AVX2__)
+#    define NEARGYE_STATE_SAVER_AVX2 1
+#    include <immintrin.h>
+#  elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#    define NEARGYE_STATE_SAVER_SSE2 1
+#    include <emmintrin.h>
+#  endif
+#endif
+
+// Diff savers report which parts of a trivial standard-layout object have changed since it was saved, as runs of changed
+// bytes, e.g. to send only deltas. The snapshot and the object are compared 32 bytes at a time with AVX2 or SSE2 if
+// available, STATE_SAVER_NO_SIMD forces the scalar comparison.
+
+namespace state_saver {
+
+// Changed part [offset, offset + size) of a saved object, in bytes, or in elements for range savers.
+struct diff_run {
+  std::size_t offset;
+  std::size_t size;
+};
+
+inline bool operator==(const diff_run& lhs, const diff_run& rhs) noexcept {
+  return lhs.offset == rhs.offset && lhs.size == rhs.size;
+}
+
+inline bool operator!=(const diff_run& lhs, const diff_run& rhs) noexcept {
+  return !(lhs == rhs);
+}
+
+namespace detail {
+
+// Bit i is set if byte i of the 32 byte blocks differs.
+inline std::uint32_t diff_mask32(const unsigned char* lhs, const unsigned char* rhs) noexcept {
+#if defined(NEARGYE_STATE_SAVER_AVX2)
+  const __m256i l = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(lhs));
+  const __m256i r = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rhs));
+  return ~static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(l, r)));
+#elif defined(NEARGYE_STATE_SAVER_SSE2)
+  const __m128i l0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lhs));
+  const __m128i r0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rhs));
+  const __m128i l1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lhs + 16));
+  const __m128i r1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rhs + 16));
+  const std::uint32_t lo = static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(l0, r0)));
+  const std::uint32_t hi = static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(l1, r1)));
+  return ~(lo | (hi << 16));
+#else
+  std::uint32_t mask = 0;
+  for (std::size_t w = 0; w < 32; w += 8) {
+    std::uint64_t l;
+    std::uint64_t r;
+    std::memcpy(&l, lhs + w, 8);
+    std::memcpy(&r, rhs + w, 8);
+    if (l != r) {
+      for (std::size_t i = w; i < w + 8; ++i) {
+        mask |= static_cast<std::uint32_t>(lhs[i] != rhs[i]) << i;
+      }
+    }
+  }
+  return mask;
+#endif
+}
+
+// Calls f(offset, size) for each run of bytes which differ between saved and live, in ascending order.
+template <typename F>
+void for_each_diff_run(const unsigned char* saved, const unsigned char* live, std::size_t size, F&& f) {
+  std::size_t first = 0;
+  bool in_run = false;
+  const auto step = [&](std::size_t i, bool changed) {
+    if (changed != in_run) {
+      if (in_run) {
+        f(first, i - first);
+      } else {
+        first = i;
+      }
+      in_run = changed;
+    }
+  };
+
+  std::size_t i = 0;
+  for (; size - i >= 32; i += 32) {
+    const std::uint32_t mask = diff_mask32(saved + i, live + i);
+    if (mask == 0) {
+      step(i, false);
+    } else if (mask == 0xFFFFFFFFu) {
+      step(i, true);
+    } else {
+      for (std::size_t j = 0; j < 32; ++j) {
+        step(i + j, ((mask >> j) & 1u) != 0);
+      }
+    }
+  }
+  for (; i < size; ++i) {
+    step(i, saved[i] != live[i]);
+  }
+  step(size, false);
+}
+
+// Calls f(offset, size) for each run of elements of size element_size which contain changed bytes.
+template <typename F>
+void for_each_diff_element_run(const unsigned char* saved, const unsigned char* live, std::size_t count, std::size_t element_size, F&& f) {
+  std::size_t first = 0;
+  std::size_t last = 0;
+  for_each_diff_run(saved, live, count * element_size, [&](std::size_t offset, std::size_t size) {
+    const std::size_t begin = offset / element_size;
+    const std::size_t end = (offset + size - 1) / element_size + 1;
+    if (last != first && begin <= last) {
+      last = end;
+      return;
+    }
+    if (last != first) {
+      f(first, last - first);
+    }
+    first = begin;
+    last = end;
+  });
+  if (last != first) {
+    f(first, last - first);
+  }
+}
+
+template <typename T, typename P>
+class diff_state_saver {
+  static_assert(is_trivially_restorable<T>::value && !std::is_const<T>::value,
+                "diff_saver requires trivial standard-layout, not empty, not const, not volatile type.");
+  static_assert(is_policy<P>::value,
+                "diff_saver requires on_exit_policy, on_fail_policy or on_success_policy.");
+
+  T& object_;
+  T previous_;
+  P policy_;
+
+  const unsigned char* previous_bytes() const noexcept {
+    return reinterpret_cast<const unsigned char*>(std::addressof(previous_));
+  }
+
+  const unsigned char* live_bytes() const noexcept {
+    return reinterpret_cast<const unsigned char*>(std::addressof(object_));
+  }
+
+ public:
+  diff_state_saver() = delete;
+  diff_state_saver(const diff_state_saver&) = delete;
+  diff_state_saver(diff_state_saver&&) = delete;
+  diff_state_saver& operator=(const diff_state_saver&) = delete;
+  diff_state_saver& operator=(diff_state_saver&&) = delete;
+
+  diff_state_saver(T&&) = delete;
+  diff_state_saver(const T&) = delete;
+
+  explicit diff_state_saver(T& object) noexcept : object_{object}, policy_{true} {
+    std::memcpy(std::addressof(previous_), std::addressof(object), sizeof(T));
+  }
+
+  // Calls f(offset, size) for each run of bytes changed since the object was saved, in ascending order.
+  // Padding bytes are compared too, including tail padding where a derived class may place its members.
+  template <typename F>
+  void for_each_diff(F&& f) const {
+    for_each_diff_run(previous_bytes(), live_bytes(), sizeof(T), std::forward<F>(f));
+  }
+
+  std::vector<diff_run> diff() const {
+    std::vector<diff_run> runs;
+    for_each_diff([&runs](std::size_t offset, std::size_t size) { runs.push_back(diff_run{offset, size}); });
+    return runs;
+  }
+
+  void dismiss() noexcept {
+    policy_.dismiss();
+  }
+
+  void restore() noexcept {
+#if defined(STATE_SAVER_COMPARE_BEFORE_RESTORE)
+    if (std::memcmp(previous_bytes(), live_bytes(), sizeof(T)) == 0) {
+      return;
+    }
+#endif
+    // As snapshot<T, true>, trivial copy assignment, not memcpy, keeps derived members in the tail padding of a base subobject.
+    object_ = previous_;
+  }
+
+  ~diff_state_saver() noexcept {
+    if (policy_.should_execute()) {
+      restore();
+    }
+  }
+};
+
+} // namespace state_saver::detail
+
+template <typename T>
+class diff_saver_exit : public detail::diff_state_saver<T, detail::on_exit_policy> {
+ public:
+  using detail::diff_state_saver<T, detail::on_exit_policy>::diff_state_saver;
+};
+
+template <typename T>
+class diff_saver_fail : public detail::diff_state_saver<T, detail::on_fail_policy> {
+ public:
+  using detail::diff_state_saver<T, detail::on_fail_policy>::diff_state_saver;
+};
+
+template <typename T>
+class diff_saver_success : public detail::diff_state_saver<T, detail::on_success_policy> {
+ public:
+  using detail::diff_state_saver<T, detail::on_success_policy>::diff_state_saver;
+};
+
+#if defined(__cpp_deduction_guides) && __cpp_deduction_guides >= 201611L
+template <typename T>
+diff_saver_exit(T&) -> diff_saver_exit<T>;
+
+template <typename T>
+diff_saver_fail(T&) -> diff_saver_fail<T>;
+
+template <typename T>
+diff_saver_success(T&) -> diff_saver_success<T>;
+#endif
+
+} // namespace state_saver
+
+#undef NEARGYE_STATE_SAVER_AVX2
+#undef NEARGYE_STATE_SAVER_SSE2
+
+#endif // NEARGYE_STATE_SAVER_DIFF_HPP
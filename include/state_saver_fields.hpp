@@ -0,0 +1,305 @@
+//   _____ _        _          _____                         _____
+//  / ____| |      | |        / ____|                       / ____|_     _
+// | (___ | |_ __ _| |_ ___  | (___   __ ___   _____ _ __  | |   _| |_ _| |_
+//  \___ \| __/ _` | __/ _ \  \___ \ / _` \ \ / / _ \ '__| | |  |_   _|_   _|
+//  ____) | || (_| | ||  __/  ____) | (_| |\ V /  __/ |    | |____|_|   |_|
+// |_____/ \__\__,_|\__\___| |_____/ \__,_| \_/ \___|_|     \_____|
+// https://github.com/Neargye/state_saver
+// version 0.9.1
+//
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2018 - 2021 Daniil Goncharov <neargye@gmail.com>.
+//
+// Permission is hereby  granted, free of charge, to any  person obtaining a copy
+// of this software and associated  documentation files (the "Software"), to deal
+// in the Software  without restriction, including without  limitation the rights
+// to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+// copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef NEARGYE_STATE_SAVER_FIELDS_HPP
+#define NEARGYE_STATE_SAVER_FIELDS_HPP
+
+#include "state_saver.hpp"
+
+#include <cstddef>
+#include <type_traits>
+
+// Fields savers save and restore only the named members of an object, instead of the whole object.
+// fields_saver_* take member pointers at run time, static_fields_saver_* (C++17) take them as template arguments,
+// so only the saved values are stored.
+
+namespace state_saver {
+
+namespace detail {
+
+#if defined(STATE_SAVER_SUPPRESS_THROW_RESTORE) && (defined(__cpp_exceptions) || defined(__EXCEPTIONS) || defined(_CPPUNWIND))
+#  define NEARGYE_NOEXCEPT(...) noexcept
+#  define NEARGYE_TRY           try {
+#  define NEARGYE_CATCH         } catch (...) { STATE_SAVER_CATCH_HANDLER }
+#else
+#  define NEARGYE_NOEXCEPT(...) noexcept(__VA_ARGS__)
+#  define NEARGYE_TRY
+#  define NEARGYE_CATCH
+#endif
+
+template <typename F>
+struct field_traits {
+  static_assert(std::is_member_object_pointer<F>::value,
+                "fields_saver requires pointer to data member.");
+};
+
+template <typename T, typename C>
+struct field_traits<T C::*> {
+  using class_type = C;
+  using type = T;
+};
+
+// Member pointer of a field, stored in the saver.
+template <typename F>
+class field_member {
+  F member_;
+
+ public:
+  explicit field_member(F member) noexcept : member_{member} {}
+
+  F member() const noexcept {
+    return member_;
+  }
+};
+
+#if defined(__cpp_nontype_template_parameter_auto)
+template <auto M>
+struct static_field {};
+
+template <auto M>
+struct field_traits<static_field<M>> : field_traits<decltype(M)> {};
+
+// Member pointer of a field known at compile time, not stored.
+template <auto M>
+class field_member<static_field<M>> {
+ public:
+  explicit field_member(static_field<M>) noexcept {}
+
+  static constexpr decltype(M) member() noexcept {
+    return M;
+  }
+};
+#endif
+
+// Saved value of a field, distinct type for each position.
+template <std::size_t I, typename F>
+class saved_field : private field_member<F> {
+  using T = typename field_traits<F>::type;
+  using C = typename field_traits<F>::class_type;
+  using assignable_t = typename restore_assignable<T>::type;
+
+  static_assert(!std::is_const<T>::value,
+                "fields_saver requires not const field.");
+  static_assert(!std::is_array<T>::value,
+                "fields_saver requires not array field.");
+  static_assert(std::is_constructible<T, T&>::value,
+                "fields_saver requires copy constructible field.");
+  static_assert(std::is_assignable<T&, assignable_t>::value,
+                "fields_saver requires field operator=.");
+
+  snapshot<T> previous_value_;
+
+ public:
+  static constexpr bool is_nothrow_constructible = std::is_nothrow_constructible<T, T&>::value;
+  static constexpr bool is_copy_assignable = std::is_assignable<T&, T&>::value;
+  static constexpr bool is_nothrow_copy_assignable = std::is_nothrow_assignable<T&, T&>::value && is_nothrow_compare<T>::value;
+  static constexpr bool is_nothrow_assign = std::is_nothrow_assignable<T&, assignable_t>::value && is_nothrow_compare<T>::value;
+
+  saved_field(C& object, F field) noexcept(is_nothrow_constructible)
+      : field_member<F>{field},
+        previous_value_{object.*field_member<F>::member()} {}
+
+  void copy_restore(C& object) noexcept(is_nothrow_copy_assignable) {
+    previous_value_.template restore<T&>(object.*field_member<F>::member());
+  }
+
+  void restore(C& object) noexcept(is_nothrow_assign) {
+    previous_value_.template restore<assignable_t>(object.*field_member<F>::member());
+  }
+};
+
+// Saved fields of an object. Each field is a base, so it may be placed in the tail padding of the previous ones.
+template <typename S, typename... F>
+class saved_fields {
+ public:
+  static constexpr bool is_nothrow_constructible = true;
+  static constexpr bool is_copy_assignable = true;
+  static constexpr bool is_nothrow_copy_assignable = true;
+  static constexpr bool is_nothrow_assign = true;
+
+  explicit saved_fields(S&) noexcept {}
+
+  void copy_restore(S&) noexcept {}
+
+  void restore(S&) noexcept {}
+};
+
+template <typename S, typename F, typename... R>
+class saved_fields<S, F, R...> : public saved_fields<S, R...>, private saved_field<sizeof...(R), F> {
+  using base_t = saved_fields<S, R...>;
+  using field_t = saved_field<sizeof...(R), F>;
+
+ public:
+  static constexpr bool is_nothrow_constructible = field_t::is_nothrow_constructible && base_t::is_nothrow_constructible;
+  static constexpr bool is_copy_assignable = field_t::is_copy_assignable && base_t::is_copy_assignable;
+  static constexpr bool is_nothrow_copy_assignable = field_t::is_nothrow_copy_assignable && base_t::is_nothrow_copy_assignable;
+  static constexpr bool is_nothrow_assign = field_t::is_nothrow_assign && base_t::is_nothrow_assign;
+
+  saved_fields(S& object, F field, R... fields) noexcept(is_nothrow_constructible)
+      : base_t{object, fields...},
+        field_t{object, field} {}
+
+  void copy_restore(S& object) noexcept(is_nothrow_copy_assignable) {
+    base_t::copy_restore(object);
+    field_t::copy_restore(object);
+  }
+
+  void restore(S& object) noexcept(is_nothrow_assign) {
+    base_t::restore(object);
+    field_t::restore(object);
+  }
+};
+
+// Saves fields of one object with one policy, restores them in reverse order.
+template <typename P, typename S, typename... F>
+class fields_state_saver : private saved_fields<S, F...> {
+  using fields_t = saved_fields<S, F...>;
+
+  static_assert(is_policy<P>::value,
+                "fields_saver requires on_exit_policy, on_fail_policy or on_success_policy.");
+  static_assert(!std::is_const<S>::value,
+                "fields_saver requires not const type.");
+  static_assert(sizeof...(F) > 0,
+                "fields_saver requires at least one field.");
+
+  S& object_;
+  P policy_;
+
+ public:
+  fields_state_saver() = delete;
+  fields_state_saver(const fields_state_saver&) = delete;
+  fields_state_saver(fields_state_saver&&) = delete;
+  fields_state_saver& operator=(const fields_state_saver&) = delete;
+  fields_state_saver& operator=(fields_state_saver&&) = delete;
+
+  fields_state_saver(S&&, F...) = delete;
+  fields_state_saver(const S&, F...) = delete;
+
+  fields_state_saver(S& object, F... fields) noexcept(fields_t::is_nothrow_constructible)
+      : fields_t{object, fields...},
+        object_{object},
+        policy_{true} {}
+
+  void dismiss() noexcept {
+    policy_.dismiss();
+  }
+
+  template <typename O = S>
+  auto restore() NEARGYE_NOEXCEPT(saved_fields<O, F...>::is_nothrow_copy_assignable) -> typename std::enable_if<std::is_same<S, O>::value && saved_fields<O, F...>::is_copy_assignable>::type {
+#if defined(STATE_SAVER_NO_THROW_RESTORE)
+    static_assert(saved_fields<O, F...>::is_nothrow_copy_assignable, "state_saver::restore requires noexcept copy operator=.");
+#endif
+    NEARGYE_TRY
+      fields_t::copy_restore(object_);
+    NEARGYE_CATCH
+  }
+
+  ~fields_state_saver() NEARGYE_NOEXCEPT(fields_t::is_nothrow_assign) {
+    if (policy_.should_execute()) {
+      NEARGYE_TRY
+        fields_t::restore(object_);
+      NEARGYE_CATCH
+    }
+  }
+};
+
+#undef NEARGYE_NOEXCEPT
+#undef NEARGYE_TRY
+#undef NEARGYE_CATCH
+
+} // namespace state_saver::detail
+
+template <typename S, typename... F>
+class fields_saver_exit : public detail::fields_state_saver<detail::on_exit_policy, S, F...> {
+ public:
+  using detail::fields_state_saver<detail::on_exit_policy, S, F...>::fields_state_saver;
+};
+
+template <typename S, typename... F>
+class fields_saver_fail : public detail::fields_state_saver<detail::on_fail_policy, S, F...> {
+ public:
+  using detail::fields_state_saver<detail::on_fail_policy, S, F...>::fields_state_saver;
+};
+
+template <typename S, typename... F>
+class fields_saver_success : public detail::fields_state_saver<detail::on_success_policy, S, F...> {
+ public:
+  using detail::fields_state_saver<detail::on_success_policy, S, F...>::fields_state_saver;
+};
+
+#if defined(__cpp_deduction_guides) && __cpp_deduction_guides >= 201611L
+template <typename S, typename... F>
+fields_saver_exit(S&, F...) -> fields_saver_exit<S, F...>;
+
+template <typename S, typename... F>
+fields_saver_fail(S&, F...) -> fields_saver_fail<S, F...>;
+
+template <typename S, typename... F>
+fields_saver_success(S&, F...) -> fields_saver_success<S, F...>;
+#endif
+
+#if defined(__cpp_nontype_template_parameter_auto)
+namespace detail {
+
+template <typename P, auto M, auto... R>
+class static_fields_state_saver : public fields_state_saver<P, typename field_traits<decltype(M)>::class_type, static_field<M>, static_field<R>...> {
+  using base_t = fields_state_saver<P, typename field_traits<decltype(M)>::class_type, static_field<M>, static_field<R>...>;
+  using S = typename field_traits<decltype(M)>::class_type;
+
+ public:
+  explicit static_fields_state_saver(S& object) noexcept(std::is_nothrow_constructible_v<base_t, S&, static_field<M>, static_field<R>...>)
+      : base_t{object, static_field<M>{}, static_field<R>{}...} {}
+};
+
+} // namespace state_saver::detail
+
+template <auto... M>
+class static_fields_saver_exit : public detail::static_fields_state_saver<detail::on_exit_policy, M...> {
+ public:
+  using detail::static_fields_state_saver<detail::on_exit_policy, M...>::static_fields_state_saver;
+};
+
+template <auto... M>
+class static_fields_saver_fail : public detail::static_fields_state_saver<detail::on_fail_policy, M...> {
+ public:
+  using detail::static_fields_state_saver<detail::on_fail_policy, M...>::static_fields_state_saver;
+};
+
+template <auto... M>
+class static_fields_saver_success : public detail::static_fields_state_saver<detail::on_success_policy, M...> {
+ public:
+  using detail::static_fields_state_saver<detail::on_success_policy, M...>::static_fields_state_saver;
+};
+#endif
+
+} // namespace state_saver
+
+#endif // NEARGYE_STATE_SAVER_FIELDS_HPP
@@ -0,0 +1,234 @@
+//   _____ _        _          _____                         _____
+//  / ____| |      | |        / ____|                       / ____|_     _
+// | (___ | |_ __ _| |_ ___  | (___   __ ___   _____ _ __  | |   _| |_ _| |_
+//  \___ \| __/ _` | __/ _ \  \___ \ / _` \ \ / / _ \ '__| | |  |_   _|_   _|
+//  ____) | || (_| | ||  __/  ____) | (_| |\ V /  __/ |    | |____|_|   |_|
+// |_____/ \__\__,_|\__\___| |_____/ \__,_| \_/ \___|_|     \_____|
+// https://github.com/Neargye/state_saver
+// version 0.9.1
+//
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2018 - 2021 Daniil Goncharov <neargye@gmail.com>.
+//
+// Permission is hereby  granted, free of charge, to any  person obtaining a copy
+// of this software and associated  documentation files (the "Software"), to deal
+// in the Software  without restriction, including without  limitation the rights
+// to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+// copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef NEARGYE_STATE_SAVER_HASH_HPP
+#define NEARGYE_STATE_SAVER_HASH_HPP
+
+#include "state_saver.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+
+// Hash savers check that an object or memory region supposed to be read-only has not been modified. They save a
+// 64-bit hash instead of a copy, so they cannot restore, on scope exit a changed hash is reported to a handler.
+
+namespace state_saver {
+
+// Called with the checked memory if it has been modified.
+using modified_handler = void (*)(const void* data, std::size_t size);
+
+namespace detail {
+
+// xxHash64, four independent lanes over 32 byte stripes. Words are read in native byte order, so on big-endian targets
+// hashes differ from xxHash64 ones, they are only compared with each other.
+class hash64 {
+  static constexpr std::uint64_t prime1 = 0x9E3779B185EBCA87ULL;
+  static constexpr std::uint64_t prime2 = 0xC2B2AE3D27D4EB4FULL;
+  static constexpr std::uint64_t prime3 = 0x165667B19E3779F9ULL;
+  static constexpr std::uint64_t prime4 = 0x85EBCA77C2B2AE63ULL;
+  static constexpr std::uint64_t prime5 = 0x27D4EB2F165667C5ULL;
+
+  static std::uint64_t rotl(std::uint64_t x, int r) noexcept {
+    return (x << r) | (x >> (64 - r));
+  }
+
+  static std::uint64_t read64(const unsigned char* p) noexcept {
+    std::uint64_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+  }
+
+  static std::uint32_t read32(const unsigned char* p) noexcept {
+    std::uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+  }
+
+  static std::uint64_t round(std::uint64_t acc, std::uint64_t input) noexcept {
+    return rotl(acc + input * prime2, 31) * prime1;
+  }
+
+  static std::uint64_t merge(std::uint64_t acc, std::uint64_t v) noexcept {
+    return (acc ^ round(0, v)) * prime1 + prime4;
+  }
+
+ public:
+  static std::uint64_t hash(const void* data, std::size_t size, std::uint64_t seed = 0) noexcept {
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    const unsigned char* const end = p + size;
+    std::uint64_t h;
+
+    if (size >= 32) {
+      std::uint64_t v1 = seed + prime1 + prime2;
+      std::uint64_t v2 = seed + prime2;
+      std::uint64_t v3 = seed;
+      std::uint64_t v4 = seed - prime1;
+      const unsigned char* const limit = end - 32;
+      do {
+        v1 = round(v1, read64(p));
+        v2 = round(v2, read64(p + 8));
+        v3 = round(v3, read64(p + 16));
+        v4 = round(v4, read64(p + 24));
+        p += 32;
+      } while (p <= limit);
+      h = rotl(v1, 1) + rotl(v2, 7) + rotl(v3, 12) + rotl(v4, 18);
+      h = merge(h, v1);
+      h = merge(h, v2);
+      h = merge(h, v3);
+      h = merge(h, v4);
+    } else {
+      h = seed + prime5;
+    }
+
+    h += static_cast<std::uint64_t>(size);
+    for (; end - p >= 8; p += 8) {
+      h = rotl(h ^ round(0, read64(p)), 27) * prime1 + prime4;
+    }
+    if (end - p >= 4) {
+      h = rotl(h ^ (static_cast<std::uint64_t>(read32(p)) * prime1), 23) * prime2 + prime3;
+      p += 4;
+    }
+    for (; p != end; ++p) {
+      h = rotl(h ^ (*p * prime5), 11) * prime1;
+    }
+
+    h ^= h >> 33;
+    h *= prime2;
+    h ^= h >> 29;
+    h *= prime3;
+    h ^= h >> 32;
+    return h;
+  }
+};
+
+// Reports in every build, not only when assertions are enabled. Whether to abort is left to a custom handler.
+inline void report_modified(const void* data, std::size_t size) noexcept {
+  std::fprintf(stderr, "state_saver: hash_saver memory [%p, +%zu) has been modified.\n", data, size);
+}
+
+// Padding bytes are hashed as well, so an object whose padding changes while its value does not is reported as
+// modified. Where the trait is available, objects are restricted to types without padding or multiple representations
+// of one value (e.g. floating point), the (data, size) constructor is not restricted.
+#if defined(__cpp_lib_has_unique_object_representations) && __cpp_lib_has_unique_object_representations >= 201606L
+template <typename T>
+struct is_hashable_object : std::integral_constant<bool, std::is_trivially_copyable<T>::value && !std::is_pointer<T>::value && std::has_unique_object_representations<T>::value> {};
+#else
+template <typename T>
+struct is_hashable_object : std::integral_constant<bool, std::is_trivially_copyable<T>::value && !std::is_pointer<T>::value> {};
+#endif
+
+template <typename P>
+class hash_state_saver {
+  static_assert(is_policy<P>::value,
+                "hash_saver requires on_exit_policy, on_fail_policy or on_success_policy.");
+
+  const void* data_;
+  std::size_t size_;
+  std::uint64_t hash_;
+  modified_handler handler_;
+  P policy_;
+
+ public:
+  hash_state_saver() = delete;
+  hash_state_saver(const hash_state_saver&) = delete;
+  hash_state_saver(hash_state_saver&&) = delete;
+  hash_state_saver& operator=(const hash_state_saver&) = delete;
+  hash_state_saver& operator=(hash_state_saver&&) = delete;
+
+  // Checks [data, data + size). Without handler, a modification is printed to stderr.
+  hash_state_saver(const void* data, std::size_t size, modified_handler handler = nullptr) noexcept
+      : data_{data},
+        size_{size},
+        hash_{hash64::hash(data, size)},
+        handler_{handler != nullptr ? handler : &report_modified},
+        policy_{true} {}
+
+  template <typename T, typename = typename std::enable_if<is_hashable_object<T>::value>::type>
+  explicit hash_state_saver(const T& object, modified_handler handler = nullptr) noexcept
+      : hash_state_saver{static_cast<const void*>(std::addressof(object)), sizeof(T), handler} {}
+
+  template <typename T, typename = typename std::enable_if<is_hashable_object<T>::value>::type>
+  hash_state_saver(const T&&, modified_handler = nullptr) = delete;
+
+  std::uint64_t saved_hash() const noexcept {
+    return hash_;
+  }
+
+  // Hashes the memory again and compares with the saved hash.
+  bool modified() const noexcept {
+    return hash64::hash(data_, size_) != hash_;
+  }
+
+  void dismiss() noexcept {
+    policy_.dismiss();
+  }
+
+  // Saves the hash of the current contents, e.g. after an intended modification.
+  void rehash() noexcept {
+    hash_ = hash64::hash(data_, size_);
+  }
+
+  ~hash_state_saver() {
+    if (policy_.should_execute() && modified()) {
+      handler_(data_, size_);
+    }
+  }
+};
+
+} // namespace state_saver::detail
+
+class hash_saver_exit : public detail::hash_state_saver<detail::on_exit_policy> {
+ public:
+  using detail::hash_state_saver<detail::on_exit_policy>::hash_state_saver;
+};
+
+class hash_saver_fail : public detail::hash_state_saver<detail::on_fail_policy> {
+ public:
+  using detail::hash_state_saver<detail::on_fail_policy>::hash_state_saver;
+};
+
+class hash_saver_success : public detail::hash_state_saver<detail::on_success_policy> {
+ public:
+  using detail::hash_state_saver<detail::on_success_policy>::hash_state_saver;
+};
+
+// Hash of [data, data + size), as saved by hash savers.
+inline std::uint64_t hash_bytes(const void* data, std::size_t size) noexcept {
+  return detail::hash64::hash(data, size);
+}
+
+} // namespace state_saver
+
+#endif // NEARGYE_STATE_SAVER_HASH_HPP
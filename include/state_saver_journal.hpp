@@ -0,0 +1,573 @@
+//   _____ _        _          _____                         _____
+//  / ____| |      | |        / ____|                       / ____|_     _
+// | (___ | |_ __ _| |_ ___  | (___   __ ___   _____ _ __  | |   _| |_ _| |_
+//  \___ \| __/ _` | __/ _ \  \___ \ / _` \ \ / / _ \ '__| | |  |_   _|_   _|
+//  ____) | || (_| | ||  __/  ____) | (_| |\ V /  __/ |    | |____|_|   |_|
+// |_____/ \__\__,_|\__\___| |_____/ \__,_| \_/ \___|_|     \_____|
+// https://github.com/Neargye/state_saver
+// version 0.9.1
+//
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2018 - 2021 Daniil Goncharov <neargye@gmail.com>.
+//
+// Permission is hereby  granted, free of charge, to any  person obtaining a copy
+// of this software and associated  documentation files (the "Software"), to deal
+// in the Software  without restriction, including without  limitation the rights
+// to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+// copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef NEARGYE_STATE_SAVER_JOURNAL_HPP
+#define NEARGYE_STATE_SAVER_JOURNAL_HPP
+
+#include "state_saver.hpp"
+
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <map>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace state_saver {
+
+namespace detail {
+
+#if defined(STATE_SAVER_SUPPRESS_THROW_RESTORE) && (defined(__cpp_exceptions) || defined(__EXCEPTIONS) || defined(_CPPUNWIND))
+#  define NEARGYE_NOEXCEPT(...) noexcept
+#  define NEARGYE_TRY           try {
+#  define NEARGYE_CATCH         } catch (...) { STATE_SAVER_CATCH_HANDLER }
+#else
+#  define NEARGYE_NOEXCEPT(...) noexcept(__VA_ARGS__)
+#  define NEARGYE_TRY
+#  define NEARGYE_CATCH
+#endif
+
+// Drops the entries pushed by an operation which has not completed.
+template <typename V>
+class journal_guard {
+  std::vector<V>& entries_;
+  typename std::vector<V>::size_type size_;
+
+ public:
+  explicit journal_guard(std::vector<V>& entries) noexcept : entries_{entries}, size_{entries.size()} {}
+
+  journal_guard(const journal_guard&) = delete;
+  journal_guard& operator=(const journal_guard&) = delete;
+
+  void commit() noexcept {
+    size_ = entries_.size();
+  }
+
+  ~journal_guard() {
+    entries_.erase(entries_.begin() + size_, entries_.end());
+  }
+};
+
+// Amortized reserve, so logging an operation never throws after the container has been changed.
+template <typename V>
+void journal_reserve(std::vector<V>& v, typename std::vector<V>::size_type count) {
+  if (v.capacity() - v.size() < count) {
+    v.reserve(v.size() + (v.size() > count ? v.size() : count));
+  }
+}
+
+template <typename C, typename P>
+class journal;
+
+// Whether the comparator of a std::map does not throw, std::less is not declared noexcept but its operator< may be.
+template <typename Compare, typename K>
+struct is_nothrow_key_compare : std::integral_constant<bool, noexcept(static_cast<bool>(std::declval<const Compare&>()(std::declval<const K&>(), std::declval<const K&>())))> {};
+
+template <typename K>
+struct is_nothrow_key_compare<std::less<K>, K> : std::integral_constant<bool, noexcept(static_cast<bool>(std::declval<const K&>() < std::declval<const K&>()))> {};
+
+// Whether relinking a node and looking up a key in the container do not throw. Inserting into std::unordered_map may
+// rehash, which allocates.
+template <typename C>
+struct is_nothrow_relink : std::false_type {};
+
+template <typename K, typename V, typename Compare, typename A>
+struct is_nothrow_relink<std::map<K, V, Compare, A>> : is_nothrow_key_compare<Compare, K> {};
+
+// Journal of the operations made on a vector, rollback undoes them in reverse order.
+// Cost is proportional to the number of operations, not to the size of the vector.
+template <typename T, typename A, typename P>
+class journal<std::vector<T, A>, P> {
+ public:
+  using container_type = std::vector<T, A>;
+  using value_type = T;
+  using size_type = typename container_type::size_type;
+  using const_reference = typename container_type::const_reference;
+
+ private:
+  static_assert(is_policy<P>::value,
+                "state_saver requires on_exit_policy, on_fail_policy or on_success_policy.");
+  static_assert(std::is_move_constructible<T>::value && std::is_move_assignable<T>::value,
+                "journal requires move constructible and move assignable value type.");
+
+  enum class operation : unsigned char {
+    insert,  // Undo: erase count elements at index.
+    erase,   // Undo: insert count saved elements at index.
+    assign,  // Undo: assign saved element at index.
+  };
+
+  struct record {
+    operation op;
+    size_type index;
+    size_type count;
+  };
+
+  // Capacity of the container never shrinks here, so undo never reallocates.
+  static constexpr bool is_nothrow_rollback = std::is_nothrow_move_constructible<T>::value && std::is_nothrow_move_assignable<T>::value;
+
+  P policy_;
+  container_type& container_;
+  std::vector<record> records_;
+  std::vector<T> values_;
+
+  void log(operation op, size_type index, size_type count) noexcept {
+    records_.push_back(record{op, index, count});
+  }
+
+  void rollback() noexcept(is_nothrow_rollback) {
+    while (!records_.empty()) {
+      const record r = records_.back();
+      switch (r.op) {
+        case operation::insert:
+          container_.erase(container_.begin() + r.index, container_.begin() + r.index + r.count);
+          break;
+        case operation::erase:
+          container_.insert(container_.begin() + r.index,
+                            std::make_move_iterator(values_.end() - r.count),
+                            std::make_move_iterator(values_.end()));
+          values_.erase(values_.end() - r.count, values_.end());
+          break;
+        case operation::assign:
+          container_[r.index] = std::move(values_.back());
+          values_.pop_back();
+          break;
+      }
+      records_.pop_back();
+    }
+  }
+
+ public:
+  journal() = delete;
+  journal(const journal&) = delete;
+  journal(journal&&) = delete;
+  journal& operator=(const journal&) = delete;
+  journal& operator=(journal&&) = delete;
+
+  journal(container_type&&) = delete;
+  journal(const container_type&) = delete;
+
+  explicit journal(container_type& container) noexcept
+      : policy_{true},
+        container_{container} {}
+
+  void dismiss() noexcept {
+    policy_.dismiss();
+  }
+
+  // Undoes all operations made through the journal and clears it.
+  void restore() NEARGYE_NOEXCEPT(is_nothrow_rollback) {
+    NEARGYE_TRY
+      rollback();
+    NEARGYE_CATCH
+  }
+
+  const container_type& get() const noexcept {
+    return container_;
+  }
+
+  const_reference operator[](size_type index) const {
+    return container_[index];
+  }
+
+  size_type size() const noexcept {
+    return container_.size();
+  }
+
+  // Number of operations recorded since construction or last restore.
+  size_type operations() const noexcept {
+    return records_.size();
+  }
+
+  void push_back(const T& value) {
+    emplace_back(value);
+  }
+
+  void push_back(T&& value) {
+    emplace_back(std::move(value));
+  }
+
+  template <typename... Args>
+  void emplace_back(Args&&... args) {
+    journal_reserve(records_, 1);
+    container_.emplace_back(std::forward<Args>(args)...);
+    log(operation::insert, container_.size() - 1, 1);
+  }
+
+  void pop_back() {
+    erase(container_.size() - 1);
+  }
+
+  void insert(size_type index, const T& value) {
+    emplace(index, value);
+  }
+
+  void insert(size_type index, T&& value) {
+    emplace(index, std::move(value));
+  }
+
+  template <typename... Args>
+  void emplace(size_type index, Args&&... args) {
+    journal_reserve(records_, 1);
+    container_.emplace(container_.begin() + index, std::forward<Args>(args)...);
+    log(operation::insert, index, 1);
+  }
+
+  void erase(size_type index) {
+    erase(index, index + 1);
+  }
+
+  void erase(size_type first, size_type last) {
+    if (first == last) {
+      return;
+    }
+    journal_reserve(records_, 1);
+    journal_reserve(values_, last - first);
+    journal_guard<T> guard{values_};
+    for (size_type i = first; i < last; ++i) {
+      values_.push_back(std::move_if_noexcept(container_[i]));
+    }
+    log(operation::erase, first, last - first);
+    guard.commit();
+    container_.erase(container_.begin() + first, container_.begin() + last);
+  }
+
+  void clear() {
+    erase(0, container_.size());
+  }
+
+  template <typename V>
+  void set(size_type index, V&& value) {
+    journal_reserve(records_, 1);
+    values_.push_back(container_[index]);
+    log(operation::assign, index, 1);
+    container_[index] = std::forward<V>(value);
+  }
+
+  void resize(size_type count) {
+    if (count < container_.size()) {
+      erase(count, container_.size());
+    } else if (count > container_.size()) {
+      journal_reserve(records_, 1);
+      const size_type size = container_.size();
+      container_.resize(count);
+      log(operation::insert, size, count - size);
+    }
+  }
+
+  void resize(size_type count, const T& value) {
+    if (count < container_.size()) {
+      erase(count, container_.size());
+    } else if (count > container_.size()) {
+      journal_reserve(records_, 1);
+      const size_type size = container_.size();
+      container_.resize(count, value);
+      log(operation::insert, size, count - size);
+    }
+  }
+
+  ~journal() NEARGYE_NOEXCEPT(is_nothrow_rollback) {
+    if (policy_.should_execute()) {
+      NEARGYE_TRY
+        rollback();
+      NEARGYE_CATCH
+    }
+  }
+};
+
+// Journal of the operations made on a map, rollback undoes them in reverse order.
+// Inserted keys are logged, overwritten values are saved, erased elements are extracted and kept as node handles, so
+// rollback relinks them without allocating. Rollback of a std::map does not throw if mapped_type has noexcept move
+// assignment and the comparator does not throw, see is_nothrow_relink. Rollback of a std::unordered_map, and before
+// C++17, where erased values are saved and reinserted, may throw: restore() then leaves the operations not undone yet
+// recorded, so calling it again resumes the rollback.
+template <typename C, typename P>
+class map_journal {
+ public:
+  using container_type = C;
+  using key_type = typename C::key_type;
+  using mapped_type = typename C::mapped_type;
+  using size_type = typename C::size_type;
+
+ private:
+  static_assert(is_policy<P>::value,
+                "state_saver requires on_exit_policy, on_fail_policy or on_success_policy.");
+  static_assert(std::is_copy_constructible<key_type>::value,
+                "journal requires copy constructible key type.");
+  static_assert(std::is_move_constructible<mapped_type>::value && std::is_move_assignable<mapped_type>::value,
+                "journal requires move constructible and move assignable mapped type.");
+
+  enum class operation : unsigned char {
+    insert,  // Undo: erase key.
+    erase,   // Undo: insert key with saved value.
+    assign,  // Undo: assign saved value to key.
+  };
+
+  struct record {
+    operation op;
+    key_type key;
+  };
+
+#if defined(__cpp_lib_node_extract) && __cpp_lib_node_extract >= 201606L
+  using node_type = typename C::node_type;
+
+  std::vector<node_type> nodes_;
+
+  void push_erased(typename C::iterator it) {
+    nodes_.push_back(container_.extract(it));
+  }
+
+  void undo_erase(record&) {
+    container_.insert(std::move(nodes_.back()));
+    nodes_.pop_back();
+  }
+
+ public:
+  static constexpr bool is_nothrow_rollback = std::is_nothrow_move_assignable<mapped_type>::value && is_nothrow_relink<C>::value;
+
+ private:
+#else
+  // Erased values, reinserted on rollback.
+  std::vector<mapped_type> nodes_;
+
+  void push_erased(typename C::iterator it) {
+    nodes_.push_back(std::move_if_noexcept(it->second));
+    container_.erase(it);
+  }
+
+  void undo_erase(record& r) {
+    container_.emplace(r.key, std::move(nodes_.back()));
+    nodes_.pop_back();
+  }
+
+ public:
+  static constexpr bool is_nothrow_rollback = false;
+
+ private:
+#endif
+
+  P policy_;
+  container_type& container_;
+  std::vector<record> records_;
+  std::vector<mapped_type> values_;
+
+  void rollback() noexcept(is_nothrow_rollback) {
+    while (!records_.empty()) {
+      record& r = records_.back();
+      switch (r.op) {
+        case operation::insert:
+          container_.erase(r.key);
+          break;
+        case operation::erase:
+          undo_erase(r);
+          break;
+        case operation::assign:
+          container_.find(r.key)->second = std::move(values_.back());
+          values_.pop_back();
+          break;
+      }
+      records_.pop_back();
+    }
+  }
+
+  template <typename... Args>
+  bool insert_new(const key_type& key, Args&&... args) {
+    journal_reserve(records_, 1);
+    journal_guard<record> guard{records_};
+    records_.push_back(record{operation::insert, key});
+    container_.emplace(std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple(std::forward<Args>(args)...));
+    guard.commit();
+    return true;
+  }
+
+ public:
+  map_journal() = delete;
+  map_journal(const map_journal&) = delete;
+  map_journal(map_journal&&) = delete;
+  map_journal& operator=(const map_journal&) = delete;
+  map_journal& operator=(map_journal&&) = delete;
+
+  map_journal(container_type&&) = delete;
+  map_journal(const container_type&) = delete;
+
+  explicit map_journal(container_type& container) noexcept
+      : policy_{true},
+        container_{container} {}
+
+  void dismiss() noexcept {
+    policy_.dismiss();
+  }
+
+  // Undoes all operations made through the journal and clears it.
+  void restore() NEARGYE_NOEXCEPT(is_nothrow_rollback) {
+    NEARGYE_TRY
+      rollback();
+    NEARGYE_CATCH
+  }
+
+  const container_type& get() const noexcept {
+    return container_;
+  }
+
+  const mapped_type& at(const key_type& key) const {
+    return container_.at(key);
+  }
+
+  size_type count(const key_type& key) const {
+    return container_.count(key);
+  }
+
+  size_type size() const noexcept {
+    return container_.size();
+  }
+
+  // Number of operations recorded since construction or last restore.
+  size_type operations() const noexcept {
+    return records_.size();
+  }
+
+  // Inserts if the key does not exist, returns true if inserted.
+  bool insert(const key_type& key, const mapped_type& value) {
+    return emplace(key, value);
+  }
+
+  bool insert(const key_type& key, mapped_type&& value) {
+    return emplace(key, std::move(value));
+  }
+
+  template <typename... Args>
+  bool emplace(const key_type& key, Args&&... args) {
+    if (container_.find(key) != container_.end()) {
+      return false;
+    }
+    return insert_new(key, std::forward<Args>(args)...);
+  }
+
+  // Inserts or assigns, returns true if inserted.
+  template <typename V>
+  bool set(const key_type& key, V&& value) {
+    const auto it = container_.find(key);
+    if (it == container_.end()) {
+      return insert_new(key, std::forward<V>(value));
+    }
+    journal_reserve(records_, 1);
+    journal_reserve(values_, 1);
+    journal_guard<record> guard{records_};
+    records_.push_back(record{operation::assign, key});
+    values_.push_back(it->second);
+    guard.commit();
+    it->second = std::forward<V>(value);
+    return false;
+  }
+
+  // Erases the key, returns number of erased elements.
+  size_type erase(const key_type& key) {
+    const auto it = container_.find(key);
+    if (it == container_.end()) {
+      return 0;
+    }
+    journal_reserve(records_, 1);
+    journal_reserve(nodes_, 1);
+    journal_guard<record> guard{records_};
+    records_.push_back(record{operation::erase, it->first});
+    push_erased(it);
+    guard.commit();
+    return 1;
+  }
+
+  void clear() {
+    journal_reserve(records_, container_.size());
+    journal_reserve(nodes_, container_.size());
+    while (!container_.empty()) {
+      erase(container_.begin()->first);
+    }
+  }
+
+  ~map_journal() NEARGYE_NOEXCEPT(is_nothrow_rollback) {
+    if (policy_.should_execute()) {
+      NEARGYE_TRY
+        rollback();
+      NEARGYE_CATCH
+    }
+  }
+};
+
+template <typename K, typename V, typename Compare, typename A, typename P>
+class journal<std::map<K, V, Compare, A>, P> : public map_journal<std::map<K, V, Compare, A>, P> {
+ public:
+  using map_journal<std::map<K, V, Compare, A>, P>::map_journal;
+};
+
+template <typename K, typename V, typename Hash, typename KeyEqual, typename A, typename P>
+class journal<std::unordered_map<K, V, Hash, KeyEqual, A>, P> : public map_journal<std::unordered_map<K, V, Hash, KeyEqual, A>, P> {
+ public:
+  using map_journal<std::unordered_map<K, V, Hash, KeyEqual, A>, P>::map_journal;
+};
+
+#undef NEARGYE_NOEXCEPT
+#undef NEARGYE_TRY
+#undef NEARGYE_CATCH
+
+} // namespace state_saver::detail
+
+template <typename C>
+class journal_saver_exit : public detail::journal<C, detail::on_exit_policy> {
+ public:
+  using detail::journal<C, detail::on_exit_policy>::journal;
+};
+
+template <typename C>
+class journal_saver_fail : public detail::journal<C, detail::on_fail_policy> {
+ public:
+  using detail::journal<C, detail::on_fail_policy>::journal;
+};
+
+template <typename C>
+class journal_saver_success : public detail::journal<C, detail::on_success_policy> {
+ public:
+  using detail::journal<C, detail::on_success_policy>::journal;
+};
+
+#if defined(__cpp_deduction_guides) && __cpp_deduction_guides >= 201611L
+template <typename C>
+journal_saver_exit(C&) -> journal_saver_exit<C>;
+
+template <typename C>
+journal_saver_fail(C&) -> journal_saver_fail<C>;
+
+template <typename C>
+journal_saver_success(C&) -> journal_saver_success<C>;
+#endif
+
+} // namespace state_saver
+
+#endif // NEARGYE_STATE_SAVER_JOURNAL_HPP
@@ -0,0 +1,305 @@
+//   _____ _        _          _____                         _____
+//  / ____| |      | |        / ____|                       / ____|_     _
+// | (___ | |_ __ _| |_ ___  | (___   __ ___   _____ _ __  | |   _| |_ _| |_
+//  \___ \| __/ _` | __/ _ \  \___ \ / _` \ \ / / _ \ '__| | |  |_   _|_   _|
+//  ____) | || (_| | ||  __/  ____) | (_| |\ V /  __/ |    | |____|_|   |_|
+// |_____/ \__\__,_|\__\___| |_____/ \__,_| \_/ \___|_|     \_____|
+// https://github.com/Neargye/state_saver
+// version 0.9.1
+//
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2018 - 2021 Daniil Goncharov <neargye@gmail.com>.
+//
+// Permission is hereby  granted, free of charge, to any  person obtaining a copy
+// of this software and associated  documentation files (the "Software"), to deal
+// in the Software  without restriction, including without  limitation the rights
+// to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+// copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef NEARGYE_STATE_SAVER_RANGE_HPP
+#define NEARGYE_STATE_SAVER_RANGE_HPP
+
+#include "state_saver.hpp"
+#include "state_saver_diff.hpp"
+
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Range savers save a subrange [first, last) of an array or contiguous container into a compact buffer, instead of
+// the whole array. Trivially copyable elements are saved and restored with memcpy.
+// Savers keep a pointer to the first saved element: a container must not reallocate (grow, shrink_to_fit, ...)
+// while its subrange is saved, restore would write to freed memory.
+
+namespace state_saver {
+
+namespace detail {
+
+#if defined(STATE_SAVER_SUPPRESS_THROW_RESTORE) && (defined(__cpp_exceptions) || defined(__EXCEPTIONS) || defined(_CPPUNWIND))
+#  define NEARGYE_NOEXCEPT(...) noexcept
+#  define NEARGYE_TRY           try {
+#  define NEARGYE_CATCH         } catch (...) { STATE_SAVER_CATCH_HANDLER }
+#else
+#  define NEARGYE_NOEXCEPT(...) noexcept(__VA_ARGS__)
+#  define NEARGYE_TRY
+#  define NEARGYE_CATCH
+#endif
+
+[[noreturn]] inline void throw_range_error(const char* message) {
+#if defined(__cpp_exceptions) || defined(__EXCEPTIONS) || defined(_CPPUNWIND)
+  throw std::out_of_range{message};
+#else
+  static_cast<void>(message);
+  std::abort();
+#endif
+}
+
+template <typename C, typename T, typename = void>
+struct is_contiguous_container_of : std::false_type {};
+
+template <typename C, typename T>
+struct is_contiguous_container_of<C, T, typename std::enable_if<std::is_same<decltype(std::declval<C&>().data()), T*>::value &&
+                                                                std::is_convertible<decltype(std::declval<C&>().size()), std::size_t>::value>::type> : std::true_type {};
+
+template <typename T>
+class saved_range {
+  using assignable_t = typename restore_assignable<T>::type;
+
+  static_assert(!std::is_const<T>::value,
+                "range_saver requires not const type.");
+  static_assert(!std::is_array<T>::value,
+                "range_saver requires not array element type.");
+  static_assert(std::is_constructible<T, T&>::value,
+                "range_saver requires copy constructible.");
+  static_assert(std::is_assignable<T&, assignable_t>::value,
+                "range_saver requires operator=.");
+
+  T* first_;
+  std::vector<T> previous_values_;
+
+  // As snapshot, operator== if available, elements without it are always restored.
+  static bool equal(const T& lhs, const T& rhs, std::true_type) noexcept(is_nothrow_compare<T>::value) {
+    return static_cast<bool>(lhs == rhs);
+  }
+
+  static bool equal(const T&, const T&, std::false_type) noexcept {
+    return false;
+  }
+
+  template <typename A>
+  void assign(std::true_type) noexcept {
+    if (previous_values_.empty()) {
+      return;
+    }
+#if defined(STATE_SAVER_COMPARE_BEFORE_RESTORE)
+    if (std::memcmp(first_, previous_values_.data(), previous_values_.size() * sizeof(T)) == 0) {
+      return;
+    }
+#endif
+    std::memcpy(first_, previous_values_.data(), previous_values_.size() * sizeof(T));
+  }
+
+  template <typename A>
+  void assign(std::false_type) noexcept(std::is_nothrow_assignable<T&, A>::value && is_nothrow_compare<T>::value) {
+    for (std::size_t i = 0; i < previous_values_.size(); ++i) {
+#if defined(STATE_SAVER_COMPARE_BEFORE_RESTORE)
+      if (equal(first_[i], previous_values_[i], is_equality_comparable<T>{})) {
+        continue;
+      }
+#endif
+      first_[i] = static_cast<A>(previous_values_[i]);
+    }
+  }
+
+  template <typename A>
+  void assign() noexcept(std::is_trivially_copyable<T>::value || (std::is_nothrow_assignable<T&, A>::value && is_nothrow_compare<T>::value)) {
+    assign<A>(std::is_trivially_copyable<T>{});
+  }
+
+ public:
+  static constexpr bool is_copy_assignable = std::is_assignable<T&, T&>::value;
+  static constexpr bool is_nothrow_copy_assignable = std::is_trivially_copyable<T>::value || (std::is_nothrow_assignable<T&, T&>::value && is_nothrow_compare<T>::value);
+  static constexpr bool is_nothrow_assign = std::is_trivially_copyable<T>::value || (std::is_nothrow_assignable<T&, assignable_t>::value && is_nothrow_compare<T>::value);
+
+  // Copies the elements with memcpy if trivially copyable, may throw std::bad_alloc.
+  saved_range(T* first, T* last) : first_{first}, previous_values_(first, last) {}
+
+  T* data() const noexcept {
+    return first_;
+  }
+
+  std::size_t size() const noexcept {
+    return previous_values_.size();
+  }
+
+  template <typename F>
+  void for_each_diff(F&& f) const {
+    static_assert(std::is_trivially_copyable<T>::value && !std::is_void<F>::value,
+                  "range_saver::diff requires trivially copyable type.");
+    for_each_diff_element_run(reinterpret_cast<const unsigned char*>(previous_values_.data()), reinterpret_cast<const unsigned char*>(first_), size(), sizeof(T), std::forward<F>(f));
+  }
+
+  void copy_restore() noexcept(is_nothrow_copy_assignable) {
+    assign<T&>();
+  }
+
+  void restore() noexcept(is_nothrow_assign) {
+    assign<assignable_t>();
+  }
+};
+
+template <typename T, typename P>
+class range_state_saver : private saved_range<T> {
+  static_assert(is_policy<P>::value,
+                "range_saver requires on_exit_policy, on_fail_policy or on_success_policy.");
+
+  P policy_;
+
+  static T* checked_data(T* data, std::size_t size, std::size_t pos, std::size_t count) {
+    if (pos > size || count > size - pos) {
+      throw_range_error("range_saver: subrange out of range.");
+    }
+    return data + pos;
+  }
+
+ public:
+  range_state_saver() = delete;
+  range_state_saver(const range_state_saver&) = delete;
+  range_state_saver(range_state_saver&&) = delete;
+  range_state_saver& operator=(const range_state_saver&) = delete;
+  range_state_saver& operator=(range_state_saver&&) = delete;
+
+  // Saves [first, last).
+  range_state_saver(T* first, T* last) : saved_range<T>{first, last}, policy_{true} {}
+
+  // Saves [first, first + count).
+  range_state_saver(T* first, std::size_t count) : range_state_saver{first, first + count} {}
+
+  // Saves [pos, pos + count) of the array, throws std::out_of_range if it does not fit.
+  template <std::size_t N>
+  range_state_saver(T (&array)[N], std::size_t pos, std::size_t count) : range_state_saver{checked_data(array, N, pos, count), count} {}
+
+  // Saves [pos, pos + count) of the container with data() and size(), throws std::out_of_range if it does not fit.
+  // The container must not reallocate while the subrange is saved.
+  template <typename C, typename = typename std::enable_if<is_contiguous_container_of<C, T>::value>::type>
+  range_state_saver(C& container, std::size_t pos, std::size_t count) : range_state_saver{checked_data(container.data(), container.size(), pos, count), count} {}
+
+  using saved_range<T>::data;
+  using saved_range<T>::size;
+
+  // Calls f(offset, size) for each run of elements changed since the range was saved, in ascending order.
+  // Elements are compared bytewise, including padding. Requires trivially copyable type.
+  using saved_range<T>::for_each_diff;
+
+  template <typename O = T>
+  auto diff() const -> typename std::enable_if<std::is_same<T, O>::value && std::is_trivially_copyable<O>::value, std::vector<diff_run>>::type {
+    std::vector<diff_run> runs;
+    saved_range<T>::for_each_diff([&runs](std::size_t offset, std::size_t size) { runs.push_back(diff_run{offset, size}); });
+    return runs;
+  }
+
+  void dismiss() noexcept {
+    policy_.dismiss();
+  }
+
+  template <typename O = T>
+  auto restore() NEARGYE_NOEXCEPT(saved_range<O>::is_nothrow_copy_assignable) -> typename std::enable_if<std::is_same<T, O>::value && saved_range<O>::is_copy_assignable>::type {
+#if defined(STATE_SAVER_NO_THROW_RESTORE)
+    static_assert(saved_range<O>::is_nothrow_copy_assignable, "state_saver::restore requires noexcept copy operator=.");
+#endif
+    NEARGYE_TRY
+      saved_range<T>::copy_restore();
+    NEARGYE_CATCH
+  }
+
+  ~range_state_saver() NEARGYE_NOEXCEPT(saved_range<T>::is_nothrow_assign) {
+    if (policy_.should_execute()) {
+      NEARGYE_TRY
+        saved_range<T>::restore();
+      NEARGYE_CATCH
+    }
+  }
+};
+
+#undef NEARGYE_NOEXCEPT
+#undef NEARGYE_TRY
+#undef NEARGYE_CATCH
+
+} // namespace state_saver::detail
+
+template <typename T>
+class range_saver_exit : public detail::range_state_saver<T, detail::on_exit_policy> {
+ public:
+  using detail::range_state_saver<T, detail::on_exit_policy>::range_state_saver;
+};
+
+template <typename T>
+class range_saver_fail : public detail::range_state_saver<T, detail::on_fail_policy> {
+ public:
+  using detail::range_state_saver<T, detail::on_fail_policy>::range_state_saver;
+};
+
+template <typename T>
+class range_saver_success : public detail::range_state_saver<T, detail::on_success_policy> {
+ public:
+  using detail::range_state_saver<T, detail::on_success_policy>::range_state_saver;
+};
+
+#if defined(__cpp_deduction_guides) && __cpp_deduction_guides >= 201611L
+template <typename T>
+range_saver_exit(T*, T*) -> range_saver_exit<T>;
+
+template <typename T>
+range_saver_exit(T*, std::size_t) -> range_saver_exit<T>;
+
+template <typename T, std::size_t N>
+range_saver_exit(T (&)[N], std::size_t, std::size_t) -> range_saver_exit<T>;
+
+template <typename C, typename T = std::remove_pointer_t<decltype(std::declval<C&>().data())>>
+range_saver_exit(C&, std::size_t, std::size_t) -> range_saver_exit<T>;
+
+template <typename T>
+range_saver_fail(T*, T*) -> range_saver_fail<T>;
+
+template <typename T>
+range_saver_fail(T*, std::size_t) -> range_saver_fail<T>;
+
+template <typename T, std::size_t N>
+range_saver_fail(T (&)[N], std::size_t, std::size_t) -> range_saver_fail<T>;
+
+template <typename C, typename T = std::remove_pointer_t<decltype(std::declval<C&>().data())>>
+range_saver_fail(C&, std::size_t, std::size_t) -> range_saver_fail<T>;
+
+template <typename T>
+range_saver_success(T*, T*) -> range_saver_success<T>;
+
+template <typename T>
+range_saver_success(T*, std::size_t) -> range_saver_success<T>;
+
+template <typename T, std::size_t N>
+range_saver_success(T (&)[N], std::size_t, std::size_t) -> range_saver_success<T>;
+
+template <typename C, typename T = std::remove_pointer_t<decltype(std::declval<C&>().data())>>
+range_saver_success(C&, std::size_t, std::size_t) -> range_saver_success<T>;
+#endif
+
+} // namespace state_saver
+
+#endif // NEARGYE_STATE_SAVER_RANGE_HPP
@@ -0,0 +1,649 @@
+//   _____ _        _          _____                         _____
+//  / ____| |      | |        / ____|                       / ____|_     _
+// | (___ | |_ __ _| |_ ___  | (___   __ ___   _____ _ __  | |   _| |_ _| |_
+//  \___ \| __/ _` | __/ _ \  \___ \ / _` \ \ / / _ \ '__| | |  |_   _|_   _|
+//  ____) | || (_| | ||  __/  ____) | (_| |\ V /  __/ |    | |____|_|   |_|
+// |_____/ \__\__,_|\__\___| |_____/ \__,_| \_/ \___|_|     \_____|
+// https://github.com/Neargye/state_saver
+// version 0.9.1
+//
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2018 - 2021 Daniil Goncharov <neargye@gmail.com>.
+//
+// Permission is hereby  granted, free of charge, to any  person obtaining a copy
+// of this software and associated  documentation files (the "Software"), to deal
+// in the Software  without restriction, including without  limitation the rights
+// to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+// copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef NEARGYE_STATE_SAVER_REGION_HPP
+#define NEARGYE_STATE_SAVER_REGION_HPP
+
+#include "state_saver.hpp"
+
+#if !defined(__linux__)
+#  error state_saver_region.hpp requires Linux.
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <system_error>
+#include <vector>
+
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+// Region savers save raw memory regions page by page, only pages written in scope are copied and restored.
+// Saved memory must be readable and writable, it is write-protected while the saver is alive.
+// Writes to protected pages by the kernel (read(2) into the region, ...) fail with EFAULT instead of faulting,
+// call prepare_write() on such memory first.
+// Region savers may be nested and may share pages: a write fault copies the page for every saver covering it, and a
+// page stays protected while any saver still watches it. Savers sharing pages must not be created or destroyed
+// concurrently with writes to those pages.
+// Saving stack memory is unsupported: the fault handler frame is pushed on the faulting thread's stack, unless an
+// alternate signal stack is set with sigaltstack(2), so a protected page there cannot be handled.
+// Soft-dirty savers copy the whole region on construction and find written pages with soft-dirty bits of
+// /proc/self/pagemap, writes do not fault and memory is not protected. Constructing or restoring clears
+// soft-dirty bits of the whole process (/proc/self/clear_refs), which breaks other users of them (CRIU, ...).
+
+namespace state_saver {
+
+namespace detail {
+
+[[noreturn]] inline void throw_region_error(const char* message) {
+#if defined(__cpp_exceptions) || defined(__EXCEPTIONS)
+  throw std::system_error{errno, std::generic_category(), message};
+#else
+  static_cast<void>(message);
+  std::abort();
+#endif
+}
+
+inline std::size_t page_size() noexcept {
+  static const std::size_t size = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+  return size;
+}
+
+// Tracks writes to a memory region with mprotect, copies each page on first write fault.
+// A page is protected while at least one tracker covering it has not copied it yet.
+class page_tracker {
+  enum : unsigned char { clean = 0, copying = 1, dirty = 2 };
+
+  static constexpr std::size_t max_trackers = 64;
+
+  unsigned char* begin_;
+  unsigned char* end_;
+  unsigned char* pages_begin_;
+  std::size_t page_size_;
+  std::size_t pages_;
+  unsigned char* shadow_;
+  std::unique_ptr<std::atomic<unsigned char>[]> state_;
+  std::size_t slot_;
+
+  static std::atomic<page_tracker*>* trackers() noexcept {
+    static std::atomic<page_tracker*> trackers[max_trackers];
+    return trackers;
+  }
+
+  static struct sigaction& previous_action() noexcept {
+    static struct sigaction action;
+    return action;
+  }
+
+  static std::mutex& action_mutex() noexcept {
+    static std::mutex mutex;
+    return mutex;
+  }
+
+  // Serializes creation, restore and destruction of trackers, which change page protection. Not used by the handler.
+  static std::mutex& protection_mutex() noexcept {
+    static std::mutex mutex;
+    return mutex;
+  }
+
+  // Copies the page of address in every tracker covering it, then unprotects the page. Async-signal-safe.
+  static bool save_address(void* address) noexcept {
+    bool saved = false;
+    std::atomic<page_tracker*>* t = trackers();
+    for (std::size_t i = 0; i < max_trackers; ++i) {
+      page_tracker* tracker = t[i].load(std::memory_order_acquire);
+      if (tracker != nullptr && tracker->save_page(address)) {
+        saved = true;
+      }
+    }
+    if (saved) {
+      const std::size_t size = page_size();
+      const std::uintptr_t page = reinterpret_cast<std::uintptr_t>(address) / size * size;
+      ::mprotect(reinterpret_cast<void*>(page), size, PROT_READ | PROT_WRITE);
+    }
+    return saved;
+  }
+
+  // Number of trackers other than this one which watch the page, i.e. cover it and have not copied it yet.
+  std::size_t watchers(const unsigned char* page) const noexcept {
+    std::size_t count = 0;
+    std::atomic<page_tracker*>* t = trackers();
+    for (std::size_t i = 0; i < max_trackers; ++i) {
+      const page_tracker* tracker = t[i].load(std::memory_order_acquire);
+      if (tracker != nullptr && tracker != this && page >= tracker->pages_begin_ && page < tracker->page(tracker->pages_)) {
+        const std::size_t index = static_cast<std::size_t>(page - tracker->pages_begin_) / page_size_;
+        count += tracker->state_[index].load(std::memory_order_acquire) == clean ? 1 : 0;
+      }
+    }
+    return count;
+  }
+
+  static void handle_fault(int signal, siginfo_t* info, void* context) {
+    if (info != nullptr && info->si_code > 0 && save_address(info->si_addr)) {
+      return;
+    }
+
+    // Not a write to a tracked region, forward to the previous handler.
+    const struct sigaction& previous = previous_action();
+    if ((previous.sa_flags & SA_SIGINFO) != 0 && previous.sa_sigaction != nullptr) {
+      previous.sa_sigaction(signal, info, context);
+    } else if (previous.sa_handler != SIG_DFL && previous.sa_handler != SIG_IGN) {
+      previous.sa_handler(signal);
+    } else {
+      // Fault is raised again with default action, on return.
+      ::signal(signal, SIG_DFL);
+    }
+  }
+
+  // Installs handler, if another handler has been installed since, it becomes the previous one.
+  static void install_handler() {
+    std::lock_guard<std::mutex> lock{action_mutex()};
+    struct sigaction current;
+    if (::sigaction(SIGSEGV, nullptr, &current) != 0) {
+      throw_region_error("state_saver: sigaction failed");
+    }
+    if ((current.sa_flags & SA_SIGINFO) != 0 && current.sa_sigaction == &handle_fault) {
+      return;
+    }
+
+    struct sigaction action;
+    std::memset(&action, 0, sizeof(action));
+    action.sa_sigaction = &handle_fault;
+    action.sa_flags = SA_SIGINFO | SA_ONSTACK | SA_RESTART;
+    ::sigemptyset(&action.sa_mask);
+    previous_action() = current;
+    if (::sigaction(SIGSEGV, &action, nullptr) != 0) {
+      throw_region_error("state_saver: sigaction failed");
+    }
+  }
+
+  unsigned char* page(std::size_t index) const noexcept {
+    return pages_begin_ + index * page_size_;
+  }
+
+  // Copies the page of address if this tracker covers it and has not copied it yet, the caller unprotects it.
+  bool save_page(void* address) noexcept {
+    unsigned char* const a = static_cast<unsigned char*>(address);
+    if (a < pages_begin_ || a >= page(pages_)) {
+      return false;
+    }
+
+    const std::size_t index = static_cast<std::size_t>(a - pages_begin_) / page_size_;
+    unsigned char expected = clean;
+    if (state_[index].compare_exchange_strong(expected, copying, std::memory_order_acq_rel)) {
+      std::memcpy(shadow_ + index * page_size_, page(index), page_size_);
+      state_[index].store(dirty, std::memory_order_release);
+    } else {
+      // Another thread is copying this page.
+      while (state_[index].load(std::memory_order_acquire) == copying) {}
+    }
+
+    return true;
+  }
+
+  void protect(std::size_t first, std::size_t last, int protection) noexcept {
+    if (first < last) {
+      ::mprotect(page(first), (last - first) * page_size_, protection);
+    }
+  }
+
+ public:
+  page_tracker(void* data, std::size_t size)
+      : begin_{static_cast<unsigned char*>(data)},
+        end_{begin_ + size},
+        pages_begin_{nullptr},
+        page_size_{page_size()},
+        pages_{0},
+        shadow_{nullptr},
+        state_{},
+        slot_{max_trackers} {
+    if (size == 0) {
+      return;
+    }
+
+    const std::uintptr_t first = reinterpret_cast<std::uintptr_t>(begin_) / page_size_ * page_size_;
+    const std::uintptr_t last = (reinterpret_cast<std::uintptr_t>(end_) + page_size_ - 1) / page_size_ * page_size_;
+    pages_begin_ = reinterpret_cast<unsigned char*>(first);
+    pages_ = (last - first) / page_size_;
+
+    state_.reset(new std::atomic<unsigned char>[pages_]());
+    install_handler();
+
+    // Shadow copy only reserves address space, physical memory is used for copied pages only.
+    void* shadow = ::mmap(nullptr, pages_ * page_size_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (shadow == MAP_FAILED) {
+      throw_region_error("state_saver: mmap failed");
+    }
+    shadow_ = static_cast<unsigned char*>(shadow);
+
+    std::lock_guard<std::mutex> lock{protection_mutex()};
+    std::atomic<page_tracker*>* t = trackers();
+    for (std::size_t i = 0; i < max_trackers && slot_ == max_trackers; ++i) {
+      page_tracker* expected = nullptr;
+      if (t[i].compare_exchange_strong(expected, this, std::memory_order_acq_rel)) {
+        slot_ = i;
+      }
+    }
+    if (slot_ == max_trackers) {
+      ::munmap(shadow_, pages_ * page_size_);
+      errno = EBUSY;
+      throw_region_error("state_saver: too many region savers");
+    }
+
+    if (::mprotect(pages_begin_, pages_ * page_size_, PROT_READ) != 0) {
+      const int error = errno;
+      t[slot_].store(nullptr, std::memory_order_release);
+      ::munmap(shadow_, pages_ * page_size_);
+      errno = error;
+      throw_region_error("state_saver: mprotect failed");
+    }
+  }
+
+  page_tracker(const page_tracker&) = delete;
+  page_tracker& operator=(const page_tracker&) = delete;
+
+  // Saves pages of [data, data + size) before they are written by the kernel or by code which must not fault.
+  // Pages are saved by every tracker covering them.
+  void prepare_write(void* data, std::size_t size) noexcept {
+    unsigned char* const first = static_cast<unsigned char*>(data);
+    for (unsigned char* p = first; p < first + size; p += page_size_) {
+      save_address(p);
+    }
+    if (size != 0) {
+      save_address(first + size - 1);
+    }
+  }
+
+  std::size_t dirty_pages() const noexcept {
+    std::size_t count = 0;
+    for (std::size_t i = 0; i < pages_; ++i) {
+      count += state_[i].load(std::memory_order_acquire) == dirty ? 1 : 0;
+    }
+    return count;
+  }
+
+  // Calls f(data, size) for each saved part of the region which has been written.
+  template <typename F>
+  void for_each_dirty(F&& f) const {
+    for (std::size_t i = 0; i < pages_; ++i) {
+      if (state_[i].load(std::memory_order_acquire) == dirty) {
+        unsigned char* const first = page(i) < begin_ ? begin_ : page(i);
+        unsigned char* const last = page(i + 1) > end_ ? end_ : page(i + 1);
+        f(static_cast<void*>(first), static_cast<std::size_t>(last - first));
+      }
+    }
+  }
+
+  // Writes back written pages. If track, they are protected again and tracked as clean.
+  void restore(bool track) noexcept {
+    std::lock_guard<std::mutex> lock{protection_mutex()};
+    std::size_t i = 0;
+    while (i < pages_) {
+      if (state_[i].load(std::memory_order_acquire) != dirty) {
+        ++i;
+        continue;
+      }
+      std::size_t last = i + 1;
+      while (last < pages_ && state_[last].load(std::memory_order_acquire) == dirty) {
+        ++last;
+      }
+
+      // Run of written pages [i, last) is restored by one copy. Parts of pages outside the region are not restored.
+      unsigned char* const first_byte = page(i) < begin_ ? begin_ : page(i);
+      unsigned char* const last_byte = page(last) > end_ ? end_ : page(last);
+      std::memcpy(first_byte, shadow_ + (first_byte - pages_begin_), static_cast<std::size_t>(last_byte - first_byte));
+      if (track) {
+        protect(i, last, PROT_READ);
+        for (std::size_t j = i; j < last; ++j) {
+          state_[j].store(clean, std::memory_order_release);
+        }
+      }
+      i = last;
+    }
+  }
+
+  // Unprotects pages which this tracker watches and no other tracker does.
+  ~page_tracker() {
+    if (pages_ == 0) {
+      return;
+    }
+    std::lock_guard<std::mutex> lock{protection_mutex()};
+    for (std::size_t i = 0; i < pages_; ++i) {
+      if (state_[i].load(std::memory_order_acquire) == clean && watchers(page(i)) == 0) {
+        std::size_t last = i + 1;
+        while (last < pages_ && state_[last].load(std::memory_order_acquire) == clean && watchers(page(last)) == 0) {
+          ++last;
+        }
+        protect(i, last, PROT_READ | PROT_WRITE);
+        i = last;
+      }
+    }
+    trackers()[slot_].store(nullptr, std::memory_order_release);
+    ::munmap(shadow_, pages_ * page_size_);
+  }
+};
+
+// Tracks writes to a memory region with soft-dirty bits of page table entries, keeps a copy of the whole region.
+// Bits of other soft-dirty trackers are saved before clearing bits of the process.
+// If the kernel does not support soft-dirty bits, all pages are treated as written.
+class soft_dirty_tracker {
+  static constexpr std::uint64_t soft_dirty_bit = std::uint64_t{1} << 55;
+  static constexpr std::size_t pagemap_batch = 512;
+
+  unsigned char* begin_;
+  unsigned char* end_;
+  unsigned char* pages_begin_;
+  std::size_t page_size_;
+  std::size_t pages_;
+  std::unique_ptr<unsigned char[]> copy_;
+  // Pages written before the last clear of soft-dirty bits, guarded by mutex().
+  mutable std::unique_ptr<bool[]> dirty_;
+  mutable bool tracking_;
+
+  static std::mutex& mutex() noexcept {
+    static std::mutex mutex;
+    return mutex;
+  }
+
+  static std::vector<soft_dirty_tracker*>& trackers() noexcept {
+    static std::vector<soft_dirty_tracker*> trackers;
+    return trackers;
+  }
+
+  static int open_proc(const char* path, int flags) noexcept {
+    int fd = -1;
+    do {
+      fd = ::open(path, flags | O_CLOEXEC);
+    } while (fd < 0 && errno == EINTR);
+    return fd;
+  }
+
+  // Calls f(index) for each page of [pages_begin, pages_begin + pages * page_size()) with soft-dirty bit set.
+  template <typename F>
+  static bool read_soft_dirty(const unsigned char* pages_begin, std::size_t pages, F&& f) noexcept {
+    const int fd = open_proc("/proc/self/pagemap", O_RDONLY);
+    if (fd < 0) {
+      return false;
+    }
+
+    const std::size_t first_entry = reinterpret_cast<std::uintptr_t>(pages_begin) / page_size();
+    std::uint64_t entries[pagemap_batch];
+    bool ok = true;
+    for (std::size_t i = 0; i < pages && ok; i += pagemap_batch) {
+      const std::size_t n = pages - i < pagemap_batch ? pages - i : pagemap_batch;
+      ::ssize_t bytes = -1;
+      do {
+        bytes = ::pread(fd, entries, n * sizeof(std::uint64_t), static_cast<::off_t>((first_entry + i) * sizeof(std::uint64_t)));
+      } while (bytes < 0 && errno == EINTR);
+      ok = bytes == static_cast<::ssize_t>(n * sizeof(std::uint64_t));
+      for (std::size_t j = 0; j < n && ok; ++j) {
+        if ((entries[j] & soft_dirty_bit) != 0) {
+          f(i + j);
+        }
+      }
+    }
+    ::close(fd);
+    return ok;
+  }
+
+  // Kernels without CONFIG_MEM_SOFT_DIRTY accept clear_refs but never set the bits, a write just after clear must set one.
+  static bool soft_dirty_works() noexcept {
+    static volatile unsigned char probe = 0;
+    probe = 1;
+    const std::uintptr_t address = reinterpret_cast<std::uintptr_t>(const_cast<unsigned char*>(&probe));
+    bool written = false;
+    read_soft_dirty(reinterpret_cast<const unsigned char*>(address / page_size() * page_size()), 1, [&written](std::size_t) { written = true; });
+    return written;
+  }
+
+  // Adds soft-dirty bits of the region to dirty_, stops tracking if they can't be read. Called with mutex() locked.
+  void collect() const noexcept {
+    if (tracking_ && !read_soft_dirty(pages_begin_, pages_, [this](std::size_t i) { dirty_[i] = true; })) {
+      tracking_ = false;
+    }
+  }
+
+  // Saves soft-dirty bits of other trackers, then clears soft-dirty bits of the process. Called with mutex() locked.
+  bool clear() noexcept {
+    for (soft_dirty_tracker* tracker : trackers()) {
+      if (tracker != this) {
+        tracker->collect();
+      }
+    }
+
+    const int fd = open_proc("/proc/self/clear_refs", O_WRONLY);
+    if (fd < 0) {
+      return false;
+    }
+    const bool cleared = ::write(fd, "4", 1) == 1;
+    ::close(fd);
+    return cleared && soft_dirty_works();
+  }
+
+  unsigned char* page(std::size_t index) const noexcept {
+    return pages_begin_ + index * page_size_;
+  }
+
+  bool is_dirty(std::size_t index) const noexcept {
+    return !tracking_ || dirty_[index];
+  }
+
+ public:
+  soft_dirty_tracker(void* data, std::size_t size)
+      : begin_{static_cast<unsigned char*>(data)},
+        end_{begin_ + size},
+        pages_begin_{nullptr},
+        page_size_{page_size()},
+        pages_{0},
+        copy_{},
+        dirty_{},
+        tracking_{false} {
+    if (size == 0) {
+      return;
+    }
+
+    const std::uintptr_t first = reinterpret_cast<std::uintptr_t>(begin_) / page_size_ * page_size_;
+    const std::uintptr_t last = (reinterpret_cast<std::uintptr_t>(end_) + page_size_ - 1) / page_size_ * page_size_;
+    pages_begin_ = reinterpret_cast<unsigned char*>(first);
+    pages_ = (last - first) / page_size_;
+
+    copy_.reset(new unsigned char[size]);
+    dirty_.reset(new bool[pages_]());
+
+    std::lock_guard<std::mutex> lock{mutex()};
+    trackers().push_back(this);
+    std::memcpy(copy_.get(), begin_, size);
+    tracking_ = clear();
+  }
+
+  soft_dirty_tracker(const soft_dirty_tracker&) = delete;
+  soft_dirty_tracker& operator=(const soft_dirty_tracker&) = delete;
+
+  std::size_t dirty_pages() const noexcept {
+    std::lock_guard<std::mutex> lock{mutex()};
+    collect();
+    std::size_t count = 0;
+    for (std::size_t i = 0; i < pages_; ++i) {
+      count += is_dirty(i) ? 1 : 0;
+    }
+    return count;
+  }
+
+  // Calls f(data, size) for each saved part of the region which has been written.
+  // f must not construct, restore or destroy soft-dirty savers.
+  template <typename F>
+  void for_each_dirty(F&& f) const {
+    std::lock_guard<std::mutex> lock{mutex()};
+    collect();
+    for (std::size_t i = 0; i < pages_; ++i) {
+      if (is_dirty(i)) {
+        unsigned char* const first = page(i) < begin_ ? begin_ : page(i);
+        unsigned char* const last = page(i + 1) > end_ ? end_ : page(i + 1);
+        f(static_cast<void*>(first), static_cast<std::size_t>(last - first));
+      }
+    }
+  }
+
+  // Writes back written pages. If track, soft-dirty bits are cleared and pages are tracked as clean.
+  void restore(bool track) noexcept {
+    if (pages_ == 0) {
+      return;
+    }
+
+    std::lock_guard<std::mutex> lock{mutex()};
+    collect();
+    std::size_t i = 0;
+    while (i < pages_) {
+      if (!is_dirty(i)) {
+        ++i;
+        continue;
+      }
+      std::size_t last = i + 1;
+      while (last < pages_ && is_dirty(last)) {
+        ++last;
+      }
+
+      // Run of written pages [i, last) is restored by one copy. Parts of pages outside the region are not restored.
+      unsigned char* const first_byte = page(i) < begin_ ? begin_ : page(i);
+      unsigned char* const last_byte = page(last) > end_ ? end_ : page(last);
+      std::memcpy(first_byte, copy_.get() + (first_byte - begin_), static_cast<std::size_t>(last_byte - first_byte));
+      i = last;
+    }
+
+    if (track) {
+      std::fill(dirty_.get(), dirty_.get() + pages_, false);
+      tracking_ = clear();
+    }
+  }
+
+  ~soft_dirty_tracker() {
+    if (pages_ == 0) {
+      return;
+    }
+    std::lock_guard<std::mutex> lock{mutex()};
+    std::vector<soft_dirty_tracker*>& t = trackers();
+    t.erase(std::find(t.begin(), t.end(), this));
+  }
+};
+
+template <typename T, typename P>
+class region_state_saver {
+  static_assert(is_policy<P>::value,
+                "state_saver requires on_exit_policy, on_fail_policy or on_success_policy.");
+
+  T tracker_;
+  P policy_;
+
+ public:
+  region_state_saver() = delete;
+  region_state_saver(const region_state_saver&) = delete;
+  region_state_saver(region_state_saver&&) = delete;
+  region_state_saver& operator=(const region_state_saver&) = delete;
+  region_state_saver& operator=(region_state_saver&&) = delete;
+
+  region_state_saver(void* data, std::size_t size)
+      : tracker_{data, size},
+        policy_{true} {}
+
+  void dismiss() noexcept {
+    policy_.dismiss();
+  }
+
+  // Restores written pages, the region stays saved.
+  void restore() noexcept {
+    tracker_.restore(true);
+  }
+
+  // Region savers only, soft-dirty bits are set by kernel writes too.
+  void prepare_write(void* data, std::size_t size) noexcept {
+    tracker_.prepare_write(data, size);
+  }
+
+  std::size_t dirty_pages() const noexcept {
+    return tracker_.dirty_pages();
+  }
+
+  template <typename F>
+  void for_each_dirty(F&& f) const {
+    tracker_.for_each_dirty(std::forward<F>(f));
+  }
+
+  ~region_state_saver() {
+    if (policy_.should_execute()) {
+      tracker_.restore(false);
+    }
+  }
+};
+
+} // namespace state_saver::detail
+
+class region_saver_exit : public detail::region_state_saver<detail::page_tracker, detail::on_exit_policy> {
+ public:
+  using detail::region_state_saver<detail::page_tracker, detail::on_exit_policy>::region_state_saver;
+};
+
+class region_saver_fail : public detail::region_state_saver<detail::page_tracker, detail::on_fail_policy> {
+ public:
+  using detail::region_state_saver<detail::page_tracker, detail::on_fail_policy>::region_state_saver;
+};
+
+class region_saver_success : public detail::region_state_saver<detail::page_tracker, detail::on_success_policy> {
+ public:
+  using detail::region_state_saver<detail::page_tracker, detail::on_success_policy>::region_state_saver;
+};
+
+class soft_dirty_saver_exit : public detail::region_state_saver<detail::soft_dirty_tracker, detail::on_exit_policy> {
+ public:
+  using detail::region_state_saver<detail::soft_dirty_tracker, detail::on_exit_policy>::region_state_saver;
+};
+
+class soft_dirty_saver_fail : public detail::region_state_saver<detail::soft_dirty_tracker, detail::on_fail_policy> {
+ public:
+  using detail::region_state_saver<detail::soft_dirty_tracker, detail::on_fail_policy>::region_state_saver;
+};
+
+class soft_dirty_saver_success : public detail::region_state_saver<detail::soft_dirty_tracker, detail::on_success_policy> {
+ public:
+  using detail::region_state_saver<detail::soft_dirty_tracker, detail::on_success_policy>::region_state_saver;
+};
+
+} // namespace state_saver
+
+#endif // NEARGYE_STATE_SAVER_REGION_HPP
@@ -0,0 +1,130 @@
+//   _____ _        _          _____                         _____
+//  / ____| |      | |        / ____|                       / ____|_     _
+// | (___ | |_ __ _| |_ ___  | (___   __ ___   _____ _ __  | |   _| |_ _| |_
+//  \___ \| __/ _` | __/ _ \  \___ \ / _` \ \ / / _ \ '__| | |  |_   _|_   _|
+//  ____) | || (_| | ||  __/  ____) | (_| |\ V /  __/ |    | |____|_|   |_|
+// |_____/ \__\__,_|\__\___| |_____/ \__,_| \_/ \___|_|     \_____|
+// https://github.com/Neargye/state_saver
+// version 0.9.1
+//
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2018 - 2021 Daniil Goncharov <neargye@gmail.com>.
+//
+// Permission is hereby  granted, free of charge, to any  person obtaining a copy
+// of this software and associated  documentation files (the "Software"), to deal
+// in the Software  without restriction, including without  limitation the rights
+// to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+// copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef NEARGYE_STATE_SAVER_REGISTRY_HPP
+#define NEARGYE_STATE_SAVER_REGISTRY_HPP
+
+#include "state_saver.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+// Saver registry saves objects enlisted during a task and restores them all at once, e.g. by a thread pool at task
+// boundaries, instead of a saver object in every task function. Each thread has its own registry (current()).
+
+namespace state_saver {
+
+namespace detail {
+
+class registry_entry {
+ public:
+  virtual ~registry_entry() = default;
+
+  virtual void restore() = 0;
+};
+
+template <typename U>
+class typed_registry_entry final : public registry_entry {
+  saved_object<U> object_;
+
+ public:
+  explicit typed_registry_entry(typename saved_object<U>::type& object) : object_{object} {}
+
+  void restore() override {
+    object_.restore();
+  }
+};
+
+} // namespace state_saver::detail
+
+class saver_registry {
+  std::vector<std::unique_ptr<detail::registry_entry>> entries_;
+
+  void enlist_objects() noexcept {}
+
+  template <typename U, typename... R>
+  void enlist_objects(U& object, R&... objects) {
+    std::unique_ptr<detail::registry_entry> entry{new detail::typed_registry_entry<U>{object}};
+    entries_.push_back(std::move(entry));
+    enlist_objects(objects...);
+  }
+
+ public:
+  saver_registry() = default;
+  saver_registry(const saver_registry&) = delete;
+  saver_registry& operator=(const saver_registry&) = delete;
+
+  // Registry of the calling thread.
+  static saver_registry& current() noexcept {
+    static thread_local saver_registry registry;
+    return registry;
+  }
+
+  // Saves the objects until rollback_all() or commit_all(). An object enlisted twice is restored to the first saved value.
+  // Enlisted objects must outlive the registry entries.
+  template <typename... U>
+  void enlist(U&... objects) {
+    entries_.reserve(entries_.size() + sizeof...(U));
+    enlist_objects(objects...);
+  }
+
+  // Restores enlisted objects in reverse order and forgets them. If a restore throws, the objects enlisted before
+  // the failed one stay enlisted.
+  void rollback_all() {
+    while (!entries_.empty()) {
+      std::unique_ptr<detail::registry_entry> entry = std::move(entries_.back());
+      entries_.pop_back();
+      entry->restore();
+    }
+  }
+
+  // Forgets enlisted objects, keeping their changes.
+  void commit_all() noexcept {
+    entries_.clear();
+  }
+
+  // Number of enlisted objects.
+  std::size_t size() const noexcept {
+    return entries_.size();
+  }
+};
+
+// Enlists the objects into the registry of the calling thread.
+template <typename... U>
+void enlist(U&... objects) {
+  saver_registry::current().enlist(objects...);
+}
+
+} // namespace state_saver
+
+#endif // NEARGYE_STATE_SAVER_REGISTRY_HPP
@@ -0,0 +1,294 @@
+//   _____ _        _          _____                         _____
+//  / ____| |      | |        / ____|                       / ____|_     _
+// | (___ | |_ __ _| |_ ___  | (___   __ ___   _____ _ __  | |   _| |_ _| |_
+//  \___ \| __/ _` | __/ _ \  \___ \ / _` \ \ / / _ \ '__| | |  |_   _|_   _|
+//  ____) | || (_| | ||  __/  ____) | (_| |\ V /  __/ |    | |____|_|   |_|
+// |_____/ \__\__,_|\__\___| |_____/ \__,_| \_/ \___|_|     \_____|
+// https://github.com/Neargye/state_saver
+// version 0.9.1
+//
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2018 - 2021 Daniil Goncharov <neargye@gmail.com>.
+//
+// Permission is hereby  granted, free of charge, to any  person obtaining a copy
+// of this software and associated  documentation files (the "Software"), to deal
+// in the Software  without restriction, including without  limitation the rights
+// to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+// copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef NEARGYE_STATE_SAVER_SAVEPOINT_HPP
+#define NEARGYE_STATE_SAVER_SAVEPOINT_HPP
+
+#include "state_saver.hpp"
+
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Savepoint savers keep a stack of savepoints over several objects, each savepoint can be rolled back to or released.
+// Objects are saved lazily: the first write access through get<I>() after a savepoint saves the object into it.
+// On release the snapshots of a savepoint are merged into its parent, an object has at most one snapshot per savepoint.
+
+namespace state_saver {
+
+namespace detail {
+
+#if defined(STATE_SAVER_SUPPRESS_THROW_RESTORE) && (defined(__cpp_exceptions) || defined(__EXCEPTIONS) || defined(_CPPUNWIND))
+#  define NEARGYE_NOEXCEPT(...) noexcept
+#  define NEARGYE_TRY           try {
+#  define NEARGYE_CATCH         } catch (...) { STATE_SAVER_CATCH_HANDLER }
+#else
+#  define NEARGYE_NOEXCEPT(...) noexcept(__VA_ARGS__)
+#  define NEARGYE_TRY
+#  define NEARGYE_CATCH
+#endif
+
+// Snapshots of one object, ordered by savepoint.
+template <typename U>
+class savepoint_object {
+ public:
+  using type = typename saved_object<U>::type;
+
+ private:
+  using T = type;
+
+  struct entry {
+    std::size_t savepoint;
+    snapshot<T> value;
+  };
+
+  T& object_;
+  std::vector<entry> saved_;
+
+  // First snapshot taken at or after savepoint.
+  std::size_t find(std::size_t savepoint) const noexcept {
+    std::size_t i = saved_.size();
+    while (i > 0 && saved_[i - 1].savepoint >= savepoint) {
+      --i;
+    }
+    return i;
+  }
+
+ public:
+  static constexpr bool is_nothrow_rollback = std::is_nothrow_assignable<T&, T&&>::value && is_nothrow_compare<T>::value;
+
+  explicit savepoint_object(T& object) noexcept : object_{object}, saved_{} {}
+
+  T& object() const noexcept {
+    return object_;
+  }
+
+  void save(std::size_t savepoint) {
+    if (saved_.empty() || saved_.back().savepoint != savepoint) {
+      saved_.push_back(entry{savepoint, snapshot<T>{object_}});
+    }
+  }
+
+  // Restores the value the object had when savepoint was marked.
+  void rollback(std::size_t savepoint) noexcept(is_nothrow_rollback) {
+    const std::size_t i = find(savepoint);
+    if (i < saved_.size()) {
+      saved_[i].value.template restore<T&&>(object_);
+      saved_.erase(saved_.begin() + static_cast<std::ptrdiff_t>(i), saved_.end());
+    }
+  }
+
+  // Merges snapshots of savepoint and above into the parent savepoint, the oldest one is kept.
+  void release(std::size_t savepoint) noexcept {
+    const std::size_t i = find(savepoint);
+    if (i == saved_.size()) {
+      return;
+    }
+    if (savepoint == 0 || (i > 0 && saved_[i - 1].savepoint == savepoint - 1)) {
+      saved_.erase(saved_.begin() + static_cast<std::ptrdiff_t>(i), saved_.end());
+    } else {
+      saved_[i].savepoint = savepoint - 1;
+      saved_.erase(saved_.begin() + static_cast<std::ptrdiff_t>(i + 1), saved_.end());
+    }
+  }
+
+  std::size_t snapshots() const noexcept {
+    return saved_.size();
+  }
+};
+
+template <typename P, typename... U>
+class savepoint_stack {
+  static_assert(is_policy<P>::value,
+                "state_saver requires on_exit_policy, on_fail_policy or on_success_policy.");
+  static_assert(sizeof...(U) > 0,
+                "savepoint_saver requires at least one object.");
+
+  using objects_t = std::tuple<savepoint_object<U>...>;
+
+  template <std::size_t I>
+  using object_t = typename std::tuple_element<I, std::tuple<typename savepoint_object<U>::type...>>::type;
+
+  objects_t objects_;
+  std::size_t depth_;
+  P policy_;
+
+  template <bool...>
+  struct bool_pack {};
+
+  static constexpr bool is_nothrow_rollback = std::is_same<bool_pack<true, savepoint_object<U>::is_nothrow_rollback...>, bool_pack<savepoint_object<U>::is_nothrow_rollback..., true>>::value;
+
+  // Objects are rolled back in reverse order.
+  template <std::size_t I>
+  auto rollback_objects(std::size_t) noexcept -> typename std::enable_if<I == 0>::type {}
+
+  template <std::size_t I>
+  auto rollback_objects(std::size_t savepoint) NEARGYE_NOEXCEPT(is_nothrow_rollback) -> typename std::enable_if<(I > 0)>::type {
+    std::get<I - 1>(objects_).rollback(savepoint);
+    rollback_objects<I - 1>(savepoint);
+  }
+
+  template <std::size_t I>
+  auto release_objects(std::size_t) noexcept -> typename std::enable_if<I == 0>::type {}
+
+  template <std::size_t I>
+  auto release_objects(std::size_t savepoint) noexcept -> typename std::enable_if<(I > 0)>::type {
+    std::get<I - 1>(objects_).release(savepoint);
+    release_objects<I - 1>(savepoint);
+  }
+
+  template <std::size_t I>
+  auto count_snapshots() const noexcept -> typename std::enable_if<I == 0, std::size_t>::type {
+    return 0;
+  }
+
+  template <std::size_t I>
+  auto count_snapshots() const noexcept -> typename std::enable_if<(I > 0), std::size_t>::type {
+    return std::get<I - 1>(objects_).snapshots() + count_snapshots<I - 1>();
+  }
+
+ public:
+  savepoint_stack() = delete;
+  savepoint_stack(const savepoint_stack&) = delete;
+  savepoint_stack(savepoint_stack&&) = delete;
+  savepoint_stack& operator=(const savepoint_stack&) = delete;
+  savepoint_stack& operator=(savepoint_stack&&) = delete;
+
+  explicit savepoint_stack(typename savepoint_object<U>::type&... objects) noexcept
+      : objects_{savepoint_object<U>{objects}...},
+        depth_{0},
+        policy_{true} {}
+
+  void dismiss() noexcept {
+    policy_.dismiss();
+  }
+
+  // Marks a savepoint, returns its id. Ids are nesting depths, the first savepoint is 0.
+  std::size_t mark() noexcept {
+    return depth_++;
+  }
+
+  // Write access, saves the object into the innermost savepoint before its first change there.
+  // All changes must be made through it.
+  template <std::size_t I>
+  object_t<I>& get() {
+    if (depth_ != 0) {
+      std::get<I>(objects_).save(depth_ - 1);
+    }
+    return std::get<I>(objects_).object();
+  }
+
+  // Read access, does not save the object.
+  template <std::size_t I>
+  const object_t<I>& cget() const noexcept {
+    return std::get<I>(objects_).object();
+  }
+
+  // Restores the objects to their state when savepoint was marked. Savepoint stays marked, savepoints above are released.
+  // Does nothing if savepoint is not marked.
+  void rollback(std::size_t savepoint) NEARGYE_NOEXCEPT(is_nothrow_rollback) {
+    if (savepoint < depth_) {
+      NEARGYE_TRY
+        rollback_objects<sizeof...(U)>(savepoint);
+      NEARGYE_CATCH
+      depth_ = savepoint + 1;
+    }
+  }
+
+  // Releases savepoint and savepoints above, keeping the changes. Their snapshots are merged into the parent savepoint.
+  // Does nothing if savepoint is not marked.
+  void release(std::size_t savepoint) noexcept {
+    if (savepoint < depth_) {
+      release_objects<sizeof...(U)>(savepoint);
+      depth_ = savepoint;
+    }
+  }
+
+  // Number of marked savepoints.
+  std::size_t depth() const noexcept {
+    return depth_;
+  }
+
+  // Number of saved object copies.
+  std::size_t snapshots() const noexcept {
+    return count_snapshots<sizeof...(U)>();
+  }
+
+  // Rolls back to the first savepoint, if any.
+  ~savepoint_stack() NEARGYE_NOEXCEPT(is_nothrow_rollback) {
+    if (depth_ != 0 && policy_.should_execute()) {
+      NEARGYE_TRY
+        rollback_objects<sizeof...(U)>(0);
+      NEARGYE_CATCH
+    }
+  }
+};
+
+#undef NEARGYE_NOEXCEPT
+#undef NEARGYE_TRY
+#undef NEARGYE_CATCH
+
+} // namespace state_saver::detail
+
+template <typename... U>
+class savepoint_saver_exit : public detail::savepoint_stack<detail::on_exit_policy, U...> {
+ public:
+  using detail::savepoint_stack<detail::on_exit_policy, U...>::savepoint_stack;
+};
+
+template <typename... U>
+class savepoint_saver_fail : public detail::savepoint_stack<detail::on_fail_policy, U...> {
+ public:
+  using detail::savepoint_stack<detail::on_fail_policy, U...>::savepoint_stack;
+};
+
+template <typename... U>
+class savepoint_saver_success : public detail::savepoint_stack<detail::on_success_policy, U...> {
+ public:
+  using detail::savepoint_stack<detail::on_success_policy, U...>::savepoint_stack;
+};
+
+#if defined(__cpp_deduction_guides) && __cpp_deduction_guides >= 201611L
+template <typename... U>
+savepoint_saver_exit(U&...) -> savepoint_saver_exit<U...>;
+
+template <typename... U>
+savepoint_saver_fail(U&...) -> savepoint_saver_fail<U...>;
+
+template <typename... U>
+savepoint_saver_success(U&...) -> savepoint_saver_success<U...>;
+#endif
+
+} // namespace state_saver
+
+#endif // NEARGYE_STATE_SAVER_SAVEPOINT_HPP
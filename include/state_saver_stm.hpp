@@ -0,0 +1,296 @@
+//   _____ _        _          _____                         _____
+//  / ____| |      | |        / ____|                       / ____|_     _
+// | (___ | |_ __ _| |_ ___  | (___   __ ___   _____ _ __  | |   _| |_ _| |_
+//  \___ \| __/ _` | __/ _ \  \___ \ / _` \ \ / / _ \ '__| | |  |_   _|_   _|
+//  ____) | || (_| | ||  __/  ____) | (_| |\ V /  __/ |    | |____|_|   |_|
+// |_____/ \__\__,_|\__\___| |_____/ \__,_| \_/ \___|_|     \_____|
+// https://github.com/Neargye/state_saver
+// version 0.9.1
+//
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2018 - 2021 Daniil Goncharov <neargye@gmail.com>.
+//
+// Permission is hereby  granted, free of charge, to any  person obtaining a copy
+// of this software and associated  documentation files (the "Software"), to deal
+// in the Software  without restriction, including without  limitation the rights
+// to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+// copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef NEARGYE_STATE_SAVER_STM_HPP
+#define NEARGYE_STATE_SAVER_STM_HPP
+
+#include "state_saver.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Software transactional memory over shared variables (tvar).
+// A transaction works on private copies of the variables it accesses and records their versions. Commit locks the
+// accessed variables in address order, validates the versions and publishes written copies by swap, so readers are
+// never blocked for the whole transaction. On conflict the transaction is discarded, shared variables are unchanged.
+// Values read inside a transaction may be inconsistent with each other until commit succeeds, valid() checks it.
+
+namespace state_saver {
+
+namespace detail {
+
+// Locks are held only to copy a variable on first access and to publish it on commit.
+class spin_mutex {
+  std::atomic<bool> locked_{false};
+
+ public:
+  void lock() noexcept {
+    while (locked_.exchange(true, std::memory_order_acquire)) {
+      std::this_thread::yield();
+    }
+  }
+
+  void unlock() noexcept {
+    locked_.store(false, std::memory_order_release);
+  }
+};
+
+class transaction_entry {
+ public:
+  virtual ~transaction_entry() = default;
+
+  virtual const void* variable() const noexcept = 0;
+
+  virtual void lock() const noexcept = 0;
+
+  virtual void unlock() const noexcept = 0;
+
+  // Called with the variable locked.
+  virtual bool valid() const noexcept = 0;
+
+  // Called with the variable locked, after all entries have been validated.
+  virtual void publish() noexcept = 0;
+};
+
+template <typename T>
+class typed_transaction_entry;
+
+} // namespace state_saver::detail
+
+template <typename T>
+class tvar {
+  static_assert(!std::is_reference<T>::value && !std::is_const<T>::value,
+                "tvar requires not reference, not const type.");
+  static_assert(std::is_copy_constructible<T>::value,
+                "tvar requires copy constructible.");
+  static_assert(detail::swap_adl::is_nothrow_swappable<T>::value,
+                "tvar requires noexcept swap.");
+
+  friend class detail::typed_transaction_entry<T>;
+
+  mutable detail::spin_mutex mutex_;
+  std::uint64_t version_;
+  T value_;
+
+ public:
+  template <typename... Args>
+  explicit tvar(Args&&... args) : mutex_{}, version_{0}, value_(std::forward<Args>(args)...) {}
+
+  tvar(const tvar&) = delete;
+  tvar& operator=(const tvar&) = delete;
+
+  // Copy of the committed value, outside transactions.
+  T load() const {
+    std::lock_guard<detail::spin_mutex> lock{mutex_};
+    return value_;
+  }
+
+  // Number of commits which have written the variable.
+  std::uint64_t version() const noexcept {
+    std::lock_guard<detail::spin_mutex> lock{mutex_};
+    return version_;
+  }
+};
+
+namespace detail {
+
+template <typename T>
+class typed_transaction_entry final : public transaction_entry {
+  tvar<T>& variable_;
+  std::uint64_t version_;
+  T copy_;
+  bool written_;
+
+  // Copies the variable under its lock.
+  struct locked_copy {
+    std::uint64_t version;
+    T value;
+
+    explicit locked_copy(tvar<T>& v) : locked_copy{v, std::unique_lock<spin_mutex>{v.mutex_}} {}
+
+    locked_copy(tvar<T>& v, std::unique_lock<spin_mutex>&&) : version{v.version_}, value(v.value_) {}
+  };
+
+  explicit typed_transaction_entry(tvar<T>& variable, locked_copy&& copy)
+      : variable_{variable},
+        version_{copy.version},
+        copy_(std::move(copy.value)),
+        written_{false} {}
+
+ public:
+  explicit typed_transaction_entry(tvar<T>& variable) : typed_transaction_entry{variable, locked_copy{variable}} {}
+
+  const void* variable() const noexcept override {
+    return &variable_;
+  }
+
+  void lock() const noexcept override {
+    variable_.mutex_.lock();
+  }
+
+  void unlock() const noexcept override {
+    variable_.mutex_.unlock();
+  }
+
+  bool valid() const noexcept override {
+    return variable_.version_ == version_;
+  }
+
+  void publish() noexcept override {
+    if (written_) {
+      swap_adl::swap_objects(variable_.value_, copy_);
+      ++variable_.version_;
+    }
+  }
+
+  const T& read() const noexcept {
+    return copy_;
+  }
+
+  T& write() noexcept {
+    written_ = true;
+    return copy_;
+  }
+};
+
+} // namespace state_saver::detail
+
+class transaction {
+  std::vector<std::unique_ptr<detail::transaction_entry>> entries_;
+
+  template <typename T>
+  detail::typed_transaction_entry<T>& entry(tvar<T>& v) {
+    for (const std::unique_ptr<detail::transaction_entry>& e : entries_) {
+      if (e->variable() == &v) {
+        return static_cast<detail::typed_transaction_entry<T>&>(*e);
+      }
+    }
+
+    std::unique_ptr<detail::typed_transaction_entry<T>> e{new detail::typed_transaction_entry<T>{v}};
+    detail::typed_transaction_entry<T>& result = *e;
+    entries_.push_back(std::move(e));
+    return result;
+  }
+
+ public:
+  transaction() = default;
+  transaction(const transaction&) = delete;
+  transaction& operator=(const transaction&) = delete;
+
+  // Read access to the private copy of the variable, taken on first access.
+  template <typename T>
+  const T& read(tvar<T>& v) {
+    return entry(v).read();
+  }
+
+  // Write access to the private copy of the variable, published on commit.
+  template <typename T>
+  T& write(tvar<T>& v) {
+    return entry(v).write();
+  }
+
+  // No accessed variable has been committed by another transaction since its first access.
+  bool valid() const noexcept {
+    for (const std::unique_ptr<detail::transaction_entry>& e : entries_) {
+      e->lock();
+      const bool valid = e->valid();
+      e->unlock();
+      if (!valid) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // Publishes written copies if the transaction is valid, returns false on conflict. The transaction is reset in both cases.
+  bool commit() {
+    // Variables are locked in address order, so concurrent commits can not deadlock.
+    std::vector<detail::transaction_entry*> locked;
+    locked.reserve(entries_.size());
+    for (const std::unique_ptr<detail::transaction_entry>& e : entries_) {
+      locked.push_back(e.get());
+    }
+    std::sort(locked.begin(), locked.end(), [](const detail::transaction_entry* a, const detail::transaction_entry* b) {
+      return std::less<const void*>{}(a->variable(), b->variable());
+    });
+
+    bool valid = true;
+    for (detail::transaction_entry* e : locked) {
+      e->lock();
+      valid = valid && e->valid();
+    }
+    for (detail::transaction_entry* e : locked) {
+      if (valid) {
+        e->publish();
+      }
+      e->unlock();
+    }
+
+    entries_.clear();
+    return valid;
+  }
+
+  // Discards private copies.
+  void reset() noexcept {
+    entries_.clear();
+  }
+
+  // Number of accessed variables.
+  std::size_t size() const noexcept {
+    return entries_.size();
+  }
+};
+
+// Runs f(transaction&) until its transaction commits, returns the number of runs.
+// Shared variables are unchanged if f throws.
+template <typename F>
+std::size_t atomically(F&& f) {
+  transaction t;
+  for (std::size_t runs = 1;; ++runs) {
+    f(t);
+    if (t.commit()) {
+      return runs;
+    }
+  }
+}
+
+} // namespace state_saver
+
+#endif // NEARGYE_STATE_SAVER_STM_HPP
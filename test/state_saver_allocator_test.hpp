@@ -0,0 +1,144 @@
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2018 - 2021 Daniil Goncharov <neargye@gmail.com>.
+//
+// Permission is hereby  granted, free of charge, to any  person obtaining a copy
+// of this software and associated  documentation files (the "Software"), to deal
+// in the Software  without restriction, including without  limitation the rights
+// to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+// copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <catch.hpp>
+
+#include <state_saver.hpp>
+
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#if defined(__has_include)
+#  if __has_include(<memory_resource>) && __cplusplus >= 201703L
+#    include <memory_resource>
+#    include <string>
+#    define STATE_SAVER_TEST_PMR 1
+#  endif
+#endif
+
+struct test_arena {
+  std::size_t allocations = 0;
+};
+
+template <typename T>
+struct test_arena_allocator {
+  using value_type = T;
+
+  test_arena* arena;
+
+  explicit test_arena_allocator(test_arena* arena) noexcept : arena{arena} {}
+
+  template <typename O>
+  test_arena_allocator(const test_arena_allocator<O>& other) noexcept : arena{other.arena} {}
+
+  T* allocate(std::size_t n) {
+    ++arena->allocations;
+    return std::allocator<T>{}.allocate(n);
+  }
+
+  void deallocate(T* p, std::size_t n) noexcept {
+    std::allocator<T>{}.deallocate(p, n);
+  }
+};
+
+template <typename T, typename O>
+bool operator==(const test_arena_allocator<T>& a, const test_arena_allocator<O>& b) noexcept {
+  return a.arena == b.arena;
+}
+
+template <typename T, typename O>
+bool operator!=(const test_arena_allocator<T>& a, const test_arena_allocator<O>& b) noexcept {
+  return a.arena != b.arena;
+}
+
+using arena_vector = std::vector<int, test_arena_allocator<int>>;
+
+// Supports only the leading allocator convention.
+struct arena_tagged {
+  using allocator_type = test_arena_allocator<int>;
+
+  arena_vector data;
+
+  explicit arena_tagged(const allocator_type& alloc) : data{{1, 2, 3}, alloc} {}
+
+  arena_tagged(const arena_tagged&) = default;
+
+  arena_tagged(std::allocator_arg_t, const allocator_type& alloc, const arena_tagged& other) : data{other.data, alloc} {}
+
+  arena_tagged& operator=(const arena_tagged&) = default;
+};
+
+TEST_CASE("saver_exit: snapshot allocated by the given allocator") {
+  test_arena object_arena;
+  test_arena snapshot_arena;
+  arena_vector v{{1, 2, 3}, test_arena_allocator<int>{&object_arena}};
+  {
+    state_saver::saver_exit<arena_vector> saver{v, test_arena_allocator<int>{&snapshot_arena}};
+    REQUIRE(snapshot_arena.allocations == 1);
+    v.assign(100, 0);
+  }
+
+  REQUIRE(v == arena_vector({1, 2, 3}, test_arena_allocator<int>{&object_arena}));
+  REQUIRE(v.get_allocator().arena == &object_arena);
+  REQUIRE(snapshot_arena.allocations == 1);
+}
+
+TEST_CASE("saver_fail: snapshot allocated with std::allocator_arg") {
+  test_arena object_arena;
+  test_arena snapshot_arena;
+  arena_tagged t{test_arena_allocator<int>{&object_arena}};
+  REQUIRE_THROWS([&]() {
+    state_saver::saver_fail<arena_tagged> saver{t, test_arena_allocator<int>{&snapshot_arena}};
+    t.data.clear();
+    throw std::runtime_error{"error"};
+  }());
+
+  REQUIRE(t.data.size() == 3);
+  REQUIRE(t.data.get_allocator().arena == &object_arena);
+  REQUIRE(snapshot_arena.allocations == 1);
+}
+
+#if defined(STATE_SAVER_TEST_PMR)
+TEST_CASE("saver_success: snapshots of several containers in one monotonic buffer") {
+  std::pmr::string s{"a string which does not fit in the small buffer"};
+  std::pmr::vector<std::pmr::string> v{"first string which does not fit in sso", "second string which does not fit in sso"};
+
+  alignas(std::max_align_t) unsigned char buffer[1024];
+  std::pmr::monotonic_buffer_resource arena{buffer, sizeof(buffer), std::pmr::null_memory_resource()};
+  {
+    state_saver::saver_success<std::pmr::string> s_saver{s, &arena};
+    state_saver::saver_success<std::pmr::vector<std::pmr::string>> v_saver{v, &arena};
+    s = "changed";
+    v.clear();
+    s_saver.restore();
+    v_saver.restore();
+  }
+
+  REQUIRE(s == "a string which does not fit in the small buffer");
+  REQUIRE(v.size() == 2);
+  REQUIRE(v[1] == "second string which does not fit in sso");
+  REQUIRE(s.get_allocator().resource() == std::pmr::get_default_resource());
+  REQUIRE(v[1].get_allocator().resource() == std::pmr::get_default_resource());
+}
+#endif
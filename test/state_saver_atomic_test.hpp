@@ -0,0 +1,217 @@
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2018 - 2021 Daniil Goncharov <neargye@gmail.com>.
+//
+// Permission is hereby  granted, free of charge, to any  person obtaining a copy
+// of this software and associated  documentation files (the "Software"), to deal
+// in the Software  without restriction, including without  limitation the rights
+// to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+// copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <catch.hpp>
+
+#include <state_saver_atomic.hpp>
+
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+TEST_CASE("atomic_saver_exit: store restore") {
+  std::atomic<int> counter{1};
+  {
+    state_saver::atomic_saver_exit<int> saver{counter, std::memory_order_acq_rel};
+    REQUIRE(saver.saved() == 1);
+    counter.store(2);
+  }
+
+  REQUIRE(counter.load() == 1);
+}
+
+TEST_CASE("atomic_saver_exit: flip a flag with one exchange") {
+  std::atomic<bool> flag{false};
+  {
+    state_saver::atomic_saver_exit<bool> saver{flag, true, std::memory_order_release};
+    REQUIRE(flag.load());
+  }
+
+  REQUIRE_FALSE(flag.load());
+}
+
+TEST_CASE("atomic_saver_exit: compare-exchange restore skips values changed by others") {
+  std::atomic<int> value{1};
+  {
+    state_saver::atomic_saver_exit<int, state_saver::atomic_restore::compare_exchange> saver{value, 2};
+    value.store(3); // Changed by another thread.
+  }
+  REQUIRE(value.load() == 3);
+
+  {
+    state_saver::atomic_saver_exit<int, state_saver::atomic_restore::compare_exchange> saver{value};
+    saver.store(4);
+  }
+  REQUIRE(value.load() == 3);
+}
+
+TEST_CASE("atomic_saver_fail: called on error") {
+  std::atomic<int> value{1};
+  REQUIRE_THROWS([&]() {
+    state_saver::atomic_saver_fail<int> saver{value, 2};
+    throw std::runtime_error{"error"};
+  }());
+  REQUIRE(value.load() == 1);
+
+  {
+    state_saver::atomic_saver_fail<int> saver{value, 2};
+  }
+  REQUIRE(value.load() == 2);
+}
+
+TEST_CASE("atomic_saver_success: restore, dismiss") {
+  std::atomic<int> value{1};
+  {
+    state_saver::atomic_saver_success<int> saver{value, 2};
+    saver.restore();
+    REQUIRE(value.load() == 1);
+    saver.store(3);
+    saver.dismiss();
+  }
+
+  REQUIRE(value.load() == 3);
+}
+
+TEST_CASE("saver_exit: std::atomic with macros") {
+  std::atomic<int> value{1};
+  {
+    SAVER_EXIT(value);
+    value.store(2);
+  }
+  REQUIRE(value.load() == 1);
+
+  WITH_SAVER_FAIL(value) {
+    value.store(3);
+  }
+  REQUIRE(value.load() == 3);
+}
+
+struct seqlock_config {
+  int values[64];
+};
+
+seqlock_config make_seqlock_config(int value) {
+  seqlock_config config;
+  for (int& v : config.values) {
+    v = value;
+  }
+  return config;
+}
+
+bool is_consistent(const seqlock_config& config) {
+  for (int v : config.values) {
+    if (v != config.values[0]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+TEST_CASE("seqlock_saver_exit: restore is one publish") {
+  state_saver::seqlock<seqlock_config> config{make_seqlock_config(1)};
+  {
+    state_saver::seqlock_saver_exit<seqlock_config> saver{config};
+    REQUIRE(saver.saved().values[0] == 1);
+    config.store(make_seqlock_config(2));
+    REQUIRE(config.load().values[63] == 2);
+  }
+
+  REQUIRE(config.load().values[63] == 1);
+  REQUIRE(config.sequence() == 4);
+}
+
+TEST_CASE("seqlock_saver_fail: called on error, macros") {
+  state_saver::seqlock<seqlock_config> config{make_seqlock_config(1)};
+  REQUIRE_THROWS([&]() {
+    SAVER_FAIL(config);
+    config.store(make_seqlock_config(2));
+    throw std::runtime_error{"error"};
+  }());
+  REQUIRE(config.load().values[0] == 1);
+
+  {
+    state_saver::seqlock_saver_success<seqlock_config> saver{config};
+    config.store(make_seqlock_config(3));
+    saver.dismiss();
+  }
+  REQUIRE(config.load().values[0] == 3);
+}
+
+TEST_CASE("seqlock_saver_exit: readers never see torn values") {
+  state_saver::seqlock<seqlock_config> config{make_seqlock_config(0)};
+  std::atomic<bool> done{false};
+  std::atomic<int> torn{0};
+  std::vector<std::thread> readers;
+  for (int i = 0; i < 2; ++i) {
+    readers.emplace_back([&]() {
+      while (!done.load()) {
+        if (!is_consistent(config.load())) {
+          torn.fetch_add(1);
+        }
+      }
+    });
+  }
+
+  for (int i = 1; i <= 2000; ++i) {
+    state_saver::seqlock_saver_exit<seqlock_config> saver{config};
+    config.store(make_seqlock_config(i));
+  }
+  done.store(true);
+  for (std::thread& reader : readers) {
+    reader.join();
+  }
+
+  REQUIRE(torn.load() == 0);
+  REQUIRE(config.load().values[0] == 0);
+}
+
+TEST_CASE("seqlock: concurrent writers never interleave") {
+  state_saver::seqlock<seqlock_config> config{make_seqlock_config(0)};
+  std::atomic<bool> done{false};
+  std::atomic<int> torn{0};
+  std::thread reader{[&]() {
+    while (!done.load()) {
+      if (!is_consistent(config.load())) {
+        torn.fetch_add(1);
+      }
+    }
+  }};
+
+  std::vector<std::thread> writers;
+  for (int w = 0; w < 2; ++w) {
+    writers.emplace_back([&config, w]() {
+      for (int i = 1; i <= 2000; ++i) {
+        config.store(make_seqlock_config(w * 10000 + i));
+      }
+    });
+  }
+  for (std::thread& writer : writers) {
+    writer.join();
+  }
+  done.store(true);
+  reader.join();
+
+  REQUIRE(torn.load() == 0);
+  REQUIRE(is_consistent(config.load()));
+  REQUIRE(config.sequence() == 2 * 2 * 2000);
+}
@@ -0,0 +1,98 @@
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2018 - 2021 Daniil Goncharov <neargye@gmail.com>.
+//
+// Permission is hereby  granted, free of charge, to any  person obtaining a copy
+// of this software and associated  documentation files (the "Software"), to deal
+// in the Software  without restriction, including without  limitation the rights
+// to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+// copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <catch.hpp>
+
+#include <state_saver.hpp>
+
+#include <cmath>
+#include <string>
+#include <utility>
+
+#if defined(STATE_SAVER_COMPARE_BEFORE_RESTORE)
+#  define assignments_if_changed(n) 0
+#else
+#  define assignments_if_changed(n) (n)
+#endif
+
+struct counted_value {
+  static int assignments;
+
+  std::string value;
+
+  explicit counted_value(std::string value) : value{std::move(value)} {}
+  counted_value(const counted_value&) = default;
+
+  counted_value& operator=(const counted_value& other) {
+    ++assignments;
+    value = other.value;
+    return *this;
+  }
+
+  counted_value& operator=(counted_value&& other) noexcept {
+    ++assignments;
+    value = std::move(other.value);
+    return *this;
+  }
+
+  friend bool operator==(const counted_value& lhs, const counted_value& rhs) noexcept {
+    return lhs.value == rhs.value;
+  }
+};
+
+int counted_value::assignments = 0;
+
+TEST_CASE("compare before restore: unchanged value is not assigned") {
+  counted_value a{"value"};
+  counted_value::assignments = 0;
+  {
+    state_saver::saver_exit<decltype(a)> saver_exit{a};
+    saver_exit.restore();
+  }
+
+  REQUIRE(counted_value::assignments == assignments_if_changed(2));
+  REQUIRE(a.value == "value");
+}
+
+TEST_CASE("compare before restore: changed value is assigned") {
+  counted_value a{"value"};
+  counted_value::assignments = 0;
+  {
+    state_saver::saver_exit<decltype(a)> saver_exit{a};
+    a.value = "other";
+  }
+
+  REQUIRE(counted_value::assignments == 1);
+  REQUIRE(a.value == "value");
+}
+
+TEST_CASE("compare before restore: bytewise for trivially copyable") {
+  double d = 0.0;
+  {
+    state_saver::saver_exit<decltype(d)> saver_exit{d};
+    d = -0.0;
+  }
+
+  REQUIRE_FALSE(std::signbit(d));
+}
+
+#undef assignments_if_changed
@@ -0,0 +1,169 @@
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2018 - 2021 Daniil Goncharov <neargye@gmail.com>.
+//
+// Permission is hereby  granted, free of charge, to any  person obtaining a copy
+// of this software and associated  documentation files (the "Software"), to deal
+// in the Software  without restriction, including without  limitation the rights
+// to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+// copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <catch.hpp>
+
+#include <state_saver_compressed.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+
+struct compressed_frame {
+  std::uint32_t id;
+  unsigned char pixels[1 << 16];
+  double scale;
+};
+
+compressed_frame compressed_frame_instance{};
+
+class compressed_base {
+  std::uint32_t a;
+  char b;
+
+ public:
+  void set(std::uint32_t x) {
+    a = x;
+    b = 0;
+  }
+};
+
+struct compressed_derived : compressed_base {
+  char c;
+};
+
+} // namespace
+
+TEST_CASE("compressed_saver_exit") {
+  SECTION("mostly zero") {
+    compressed_frame& f = compressed_frame_instance;
+    std::memset(&f, 0, sizeof(f));
+    f.id = 7;
+    f.pixels[1000] = 1;
+    f.pixels[1001] = 2;
+    f.scale = 2.0;
+    compressed_frame saved;
+    std::memcpy(&saved, &f, sizeof(f));
+
+    {
+      state_saver::compressed_saver_exit<compressed_frame> state_saver{f};
+      REQUIRE(state_saver.compressed_size() < 64);
+      std::memset(f.pixels, 0xAB, sizeof(f.pixels));
+      f.id = 0;
+      f.scale = 0.0;
+    }
+
+    REQUIRE(std::memcmp(&saved, &f, sizeof(f)) == 0);
+  }
+
+  SECTION("low entropy") {
+    unsigned char buffer[4096];
+    for (std::size_t i = 0; i < sizeof(buffer); ++i) {
+      buffer[i] = static_cast<unsigned char>(i / 100);
+    }
+    unsigned char saved[sizeof(buffer)];
+    std::memcpy(saved, buffer, sizeof(buffer));
+
+    {
+      state_saver::compressed_saver_exit<unsigned char[4096]> state_saver{buffer};
+      REQUIRE(state_saver.compressed_size() < sizeof(buffer) / 10);
+      std::memset(buffer, 0, sizeof(buffer));
+    }
+
+    REQUIRE(std::memcmp(saved, buffer, sizeof(buffer)) == 0);
+  }
+
+  SECTION("incompressible") {
+    unsigned char buffer[1000];
+    std::uint32_t seed = 3;
+    for (unsigned char& c : buffer) {
+      seed = seed * 1664525u + 1013904223u;
+      c = static_cast<unsigned char>(seed >> 24);
+    }
+    buffer[500] = buffer[501] = buffer[502] = buffer[503] = buffer[504] = 9;
+    unsigned char saved[sizeof(buffer)];
+    std::memcpy(saved, buffer, sizeof(buffer));
+
+    {
+      state_saver::compressed_saver_exit<unsigned char[1000]> state_saver{buffer};
+      REQUIRE(state_saver.compressed_size() <= sizeof(buffer) + 8);
+      std::memset(buffer, 0, sizeof(buffer));
+    }
+
+    REQUIRE(std::memcmp(saved, buffer, sizeof(buffer)) == 0);
+  }
+}
+
+TEST_CASE("compressed_saver_fail") {
+  std::uint64_t counters[512] = {};
+
+  SECTION("exception") {
+    try {
+      state_saver::compressed_saver_fail<std::uint64_t[512]> state_saver{counters};
+      counters[100] = 1;
+      throw std::runtime_error{"fail"};
+    } catch (...) {}
+
+    REQUIRE(counters[100] == 0);
+  }
+
+  SECTION("no exception") {
+    {
+      state_saver::compressed_saver_fail<std::uint64_t[512]> state_saver{counters};
+      counters[100] = 1;
+    }
+
+    REQUIRE(counters[100] == 1);
+  }
+}
+
+TEST_CASE("compressed_saver_success") {
+  int value = 1;
+
+  {
+    state_saver::compressed_saver_success<int> state_saver{value};
+    value = 2;
+    state_saver.restore();
+    REQUIRE(value == 1);
+    value = 3;
+    state_saver.dismiss();
+  }
+
+  REQUIRE(value == 3);
+}
+
+TEST_CASE("compressed_saver_exit: base subobject restore keeps derived members") {
+  compressed_derived d{};
+  d.set(1);
+  d.c = 7;
+  compressed_base& b = d;
+  {
+    state_saver::compressed_saver_exit<compressed_base> state_saver{b};
+    b.set(2);
+    d.c = 9;
+  }
+
+  REQUIRE(d.c == 9);
+}
@@ -0,0 +1,378 @@
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2018 - 2021 Daniil Goncharov <neargye@gmail.com>.
+//
+// Permission is hereby  granted, free of charge, to any  person obtaining a copy
+// of this software and associated  documentation files (the "Software"), to deal
+// in the Software  without restriction, including without  limitation the rights
+// to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+// copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#if defined(__cpp_impl_coroutine) && defined(__has_include)
+#if __has_include(<coroutine>)
+
+#include <catch.hpp>
+
+#include <state_saver_coroutine.hpp>
+
+#include <coroutine>
+#include <exception>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+
+struct coroutine_task {
+  struct promise_type : state_saver::saver_promise_base {
+    std::exception_ptr exception;
+
+    coroutine_task get_return_object() {
+      return coroutine_task{std::coroutine_handle<promise_type>::from_promise(*this)};
+    }
+
+    std::suspend_never initial_suspend() noexcept {
+      return {};
+    }
+
+    std::suspend_always final_suspend() noexcept {
+      return {};
+    }
+
+    void return_void() noexcept {}
+
+    void unhandled_exception() noexcept {
+      exception = std::current_exception();
+    }
+  };
+
+  std::coroutine_handle<promise_type> handle;
+
+  explicit coroutine_task(std::coroutine_handle<promise_type> h) noexcept : handle{h} {}
+
+  coroutine_task(const coroutine_task&) = delete;
+  coroutine_task& operator=(const coroutine_task&) = delete;
+
+  ~coroutine_task() {
+    handle.destroy();
+  }
+
+  bool failed() const noexcept {
+    return handle.promise().exception != nullptr;
+  }
+};
+
+// Generator and lazy task, yield and initial suspend are tracked.
+struct coroutine_generator {
+  struct promise_type : state_saver::saver_promise_base {
+    int value = 0;
+    bool lazy = false;
+
+    promise_type() = default;
+
+    template <typename... Args>
+    explicit promise_type(bool l, Args&&...) noexcept : lazy{l} {}
+
+    coroutine_generator get_return_object() {
+      return coroutine_generator{std::coroutine_handle<promise_type>::from_promise(*this)};
+    }
+
+    auto initial_suspend() noexcept {
+      struct maybe_suspend {
+        bool suspend;
+
+        bool await_ready() const noexcept {
+          return !suspend;
+        }
+
+        void await_suspend(std::coroutine_handle<>) const noexcept {}
+
+        void await_resume() const noexcept {}
+      };
+      return track_resume(maybe_suspend{lazy});
+    }
+
+    std::suspend_always final_suspend() noexcept {
+      return {};
+    }
+
+    auto yield_value(int v) noexcept {
+      value = v;
+      return track_resume(std::suspend_always{});
+    }
+
+    void return_void() noexcept {}
+
+    void unhandled_exception() noexcept {
+      exception = std::current_exception();
+    }
+
+    std::exception_ptr exception;
+  };
+
+  std::coroutine_handle<promise_type> handle;
+
+  explicit coroutine_generator(std::coroutine_handle<promise_type> h) noexcept : handle{h} {}
+
+  coroutine_generator(const coroutine_generator&) = delete;
+  coroutine_generator& operator=(const coroutine_generator&) = delete;
+
+  ~coroutine_generator() {
+    handle.destroy();
+  }
+
+  bool failed() const noexcept {
+    return handle.promise().exception != nullptr;
+  }
+};
+
+// Suspends and leaves the handle to be resumed by the test.
+struct pause {
+  std::coroutine_handle<>& handle;
+
+  bool await_ready() const noexcept {
+    return false;
+  }
+
+  void await_suspend(std::coroutine_handle<> h) noexcept {
+    handle = h;
+  }
+
+  void await_resume() const noexcept {}
+};
+
+// Resumes the handle from a destructor which runs during unwinding.
+struct unwinding_resume {
+  std::coroutine_handle<>& handle;
+
+  ~unwinding_resume() {
+    handle.resume();
+  }
+};
+
+void resume_while_unwinding(std::coroutine_handle<>& handle) {
+  try {
+    unwinding_resume r{handle};
+    throw std::runtime_error{"unwinding"};
+  } catch (...) {}
+}
+
+coroutine_task fail_task(int& a, std::coroutine_handle<>& handle, bool fail) {
+  COROUTINE_SAVER_FAIL(a);
+  a = 1;
+  co_await pause{handle};
+  a = 2;
+  if (fail) {
+    throw std::runtime_error{"fail"};
+  }
+}
+
+coroutine_task success_task(int& a, std::coroutine_handle<>& handle, bool fail) {
+  state_saver::coroutine_saver_success s{a, co_await state_saver::this_saver_promise};
+  a = 1;
+  co_await pause{handle};
+  a = 2;
+  if (fail) {
+    throw std::runtime_error{"fail"};
+  }
+}
+
+coroutine_task dismiss_task(int& a, std::coroutine_handle<>& handle) {
+  state_saver::coroutine_saver_fail<int> s{a, co_await state_saver::this_saver_promise};
+  a = 1;
+  co_await pause{handle};
+  s.dismiss();
+  throw std::runtime_error{"fail"};
+}
+
+coroutine_generator generator_task(bool /*lazy*/, int& a, bool fail) {
+  COROUTINE_SAVER_FAIL(a);
+  a = 1;
+  co_yield 1;
+  a = 2;
+  if (fail) {
+    throw std::runtime_error{"fail"};
+  }
+}
+
+// Resumes the handle from a destructor which runs during unwinding.
+struct unwinding_generator_resume {
+  std::coroutine_handle<> handle;
+
+  ~unwinding_generator_resume() {
+    handle.resume();
+  }
+};
+
+void resume_generator_while_unwinding(std::coroutine_handle<> handle) {
+  try {
+    unwinding_generator_resume r{handle};
+    throw std::runtime_error{"unwinding"};
+  } catch (...) {}
+}
+
+} // namespace
+
+TEST_CASE("coroutine_saver_fail") {
+  std::coroutine_handle<> handle;
+
+  SECTION("no exception") {
+    int a = 0;
+    coroutine_task t = fail_task(a, handle, false);
+    REQUIRE(a == 1);
+    handle.resume();
+    REQUIRE_FALSE(t.failed());
+    REQUIRE(a == 2);
+  }
+
+  SECTION("exception") {
+    int a = 0;
+    coroutine_task t = fail_task(a, handle, true);
+    handle.resume();
+    REQUIRE(t.failed());
+    REQUIRE(a == 0);
+  }
+
+  SECTION("dismiss") {
+    int a = 0;
+    coroutine_task t = dismiss_task(a, handle);
+    handle.resume();
+    REQUIRE(t.failed());
+    REQUIRE(a == 1);
+  }
+
+  SECTION("resume on another thread") {
+    int a = 0;
+    coroutine_task t = fail_task(a, handle, true);
+    std::thread{[&handle]() { handle.resume(); }}.join();
+    REQUIRE(t.failed());
+    REQUIRE(a == 0);
+  }
+
+  SECTION("resume while unwinding, no exception") {
+    int a = 0;
+    coroutine_task t = fail_task(a, handle, false);
+    resume_while_unwinding(handle);
+    REQUIRE_FALSE(t.failed());
+    REQUIRE(a == 2);
+  }
+
+  SECTION("start while unwinding, exception") {
+    int a = 0;
+    coroutine_task* t = nullptr;
+    struct starter {
+      int& a;
+      std::coroutine_handle<>& handle;
+      coroutine_task*& t;
+
+      ~starter() {
+        t = new coroutine_task{fail_task(a, handle, true)};
+      }
+    };
+    try {
+      starter s{a, handle, t};
+      throw std::runtime_error{"unwinding"};
+    } catch (...) {}
+    REQUIRE(a == 1);
+    handle.resume();
+    REQUIRE(t->failed());
+    REQUIRE(a == 0);
+    delete t;
+  }
+}
+
+TEST_CASE("coroutine_saver_success") {
+  std::coroutine_handle<> handle;
+
+  SECTION("no exception") {
+    int a = 0;
+    coroutine_task t = success_task(a, handle, false);
+    std::thread{[&handle]() { handle.resume(); }}.join();
+    REQUIRE_FALSE(t.failed());
+    REQUIRE(a == 0);
+  }
+
+  SECTION("exception") {
+    int a = 0;
+    coroutine_task t = success_task(a, handle, true);
+    handle.resume();
+    REQUIRE(t.failed());
+    REQUIRE(a == 2);
+  }
+
+  SECTION("resume while unwinding, no exception") {
+    int a = 0;
+    coroutine_task t = success_task(a, handle, false);
+    resume_while_unwinding(handle);
+    REQUIRE_FALSE(t.failed());
+    REQUIRE(a == 0);
+  }
+}
+
+TEST_CASE("coroutine_saver_fail: yield and initial suspend") {
+  SECTION("generator resumed while unwinding, no exception") {
+    int a = 0;
+    coroutine_generator g = generator_task(false, a, false);
+    REQUIRE(g.handle.promise().value == 1);
+    resume_generator_while_unwinding(g.handle);
+    REQUIRE(g.handle.done());
+    REQUIRE_FALSE(g.failed());
+    REQUIRE(a == 2);
+  }
+
+  SECTION("generator resumed while unwinding, exception") {
+    int a = 0;
+    coroutine_generator g = generator_task(false, a, true);
+    resume_generator_while_unwinding(g.handle);
+    REQUIRE(g.failed());
+    REQUIRE(a == 0);
+  }
+
+  SECTION("lazy task created while unwinding, exception") {
+    int a = 0;
+    coroutine_generator* g = nullptr;
+    struct starter {
+      int& a;
+      coroutine_generator*& g;
+
+      ~starter() {
+        g = new coroutine_generator{generator_task(true, a, true)};
+      }
+    };
+    try {
+      starter s{a, g};
+      throw std::runtime_error{"unwinding"};
+    } catch (...) {}
+    REQUIRE(a == 0);
+    g->handle.resume();
+    REQUIRE(a == 1);
+    g->handle.resume();
+    REQUIRE(g->failed());
+    REQUIRE(a == 0);
+    delete g;
+  }
+
+  SECTION("lazy task resumed while unwinding, no exception") {
+    int a = 0;
+    coroutine_generator g = generator_task(true, a, false);
+    resume_generator_while_unwinding(g.handle);
+    REQUIRE(a == 1);
+    resume_generator_while_unwinding(g.handle);
+    REQUIRE_FALSE(g.failed());
+    REQUIRE(a == 2);
+  }
+}
+
+#endif
+#endif
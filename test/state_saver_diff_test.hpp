@@ -0,0 +1,173 @@
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2018 - 2021 Daniil Goncharov <neargye@gmail.com>.
+//
+// Permission is hereby  granted, free of charge, to any  person obtaining a copy
+// of this software and associated  documentation files (the "Software"), to deal
+// in the Software  without restriction, including without  limitation the rights
+// to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+// copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <catch.hpp>
+
+#include <state_saver_diff.hpp>
+#include <state_saver_range.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+struct diff_packet {
+  std::uint32_t header;
+  unsigned char payload[200];
+  std::uint64_t checksum;
+};
+
+class diff_base {
+  std::uint32_t a;
+  char b;
+
+ public:
+  void set(std::uint32_t x) {
+    a = x;
+    b = 0;
+  }
+};
+
+struct diff_derived : diff_base {
+  char c;
+};
+
+std::vector<state_saver::diff_run> naive_diff(const unsigned char* saved, const unsigned char* live, std::size_t size) {
+  std::vector<state_saver::diff_run> runs;
+  for (std::size_t i = 0; i < size;) {
+    if (saved[i] == live[i]) {
+      ++i;
+      continue;
+    }
+    std::size_t last = i;
+    while (last < size && saved[last] != live[last]) {
+      ++last;
+    }
+    runs.push_back(state_saver::diff_run{i, last - i});
+    i = last;
+  }
+  return runs;
+}
+
+} // namespace
+
+TEST_CASE("diff_saver_exit") {
+  diff_packet p{};
+
+  SECTION("no change") {
+    state_saver::diff_saver_exit<diff_packet> state_saver{p};
+    REQUIRE(state_saver.diff().empty());
+  }
+
+  SECTION("runs") {
+    {
+      state_saver::diff_saver_exit<diff_packet> state_saver{p};
+      p.header = 0xFFFFFFFF;
+      p.payload[10] = 1;
+      p.payload[11] = 1;
+      for (std::size_t i = 40; i < 140; ++i) {
+        p.payload[i] = 2;
+      }
+      p.checksum = 7;
+
+      const std::vector<state_saver::diff_run> expected{
+          {0, 4},
+          {offsetof(diff_packet, payload) + 10, 2},
+          {offsetof(diff_packet, payload) + 40, 100},
+          {offsetof(diff_packet, checksum), 1}};
+      REQUIRE(state_saver.diff() == expected);
+
+      std::size_t changed = 0;
+      state_saver.for_each_diff([&changed](std::size_t, std::size_t size) { changed += size; });
+      REQUIRE(changed == 4 + 2 + 100 + 1);
+    }
+    REQUIRE(p.header == 0);
+    REQUIRE(p.payload[50] == 0);
+    REQUIRE(p.checksum == 0);
+  }
+
+  SECTION("matches bytewise comparison") {
+    unsigned char saved[sizeof(diff_packet)];
+    std::uint32_t seed = 1;
+    for (int round = 0; round < 64; ++round) {
+      state_saver::diff_saver_exit<diff_packet> state_saver{p};
+      std::memcpy(saved, &p, sizeof(p));
+      unsigned char* bytes = reinterpret_cast<unsigned char*>(&p);
+      for (int k = 0; k < round; ++k) {
+        seed = seed * 1664525u + 1013904223u;
+        bytes[(seed >> 8) % sizeof(p)] ^= static_cast<unsigned char>(1 + (seed & 0x7F));
+      }
+      REQUIRE(state_saver.diff() == naive_diff(saved, bytes, sizeof(p)));
+    }
+  }
+}
+
+TEST_CASE("diff_saver_fail") {
+  diff_packet p{};
+
+  try {
+    state_saver::diff_saver_fail<diff_packet> state_saver{p};
+    p.payload[0] = 1;
+    REQUIRE(state_saver.diff().size() == 1);
+    throw std::runtime_error{"fail"};
+  } catch (...) {}
+
+  REQUIRE(p.payload[0] == 0);
+}
+
+TEST_CASE("diff_saver_exit: base subobject restore keeps derived members") {
+  diff_derived d{};
+  d.set(1);
+  d.c = 7;
+  diff_base& b = d;
+  {
+    state_saver::diff_saver_exit<diff_base> state_saver{b};
+    b.set(2);
+    d.c = 9;
+  }
+
+  REQUIRE(d.c == 9);
+}
+
+TEST_CASE("range_saver diff") {
+  std::vector<std::uint16_t> v(1000);
+
+  state_saver::range_saver_exit<std::uint16_t> state_saver{v, 100, 500};
+  REQUIRE(state_saver.diff().empty());
+
+  v[0] = 1;
+  v[100] = 1;
+  v[101] = 1;
+  v[103] = 1;
+  v[104] = 1;
+  for (std::size_t i = 300; i < 400; ++i) {
+    v[i] = static_cast<std::uint16_t>(i);
+  }
+  v[599] = 1;
+  v[600] = 1;
+
+  const std::vector<state_saver::diff_run> expected{{0, 2}, {3, 2}, {200, 100}, {499, 1}};
+  REQUIRE(state_saver.diff() == expected);
+}
@@ -0,0 +1,162 @@
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2018 - 2021 Daniil Goncharov <neargye@gmail.com>.
+//
+// Permission is hereby  granted, free of charge, to any  person obtaining a copy
+// of this software and associated  documentation files (the "Software"), to deal
+// in the Software  without restriction, including without  limitation the rights
+// to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+// copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <catch.hpp>
+
+#include <state_saver_fields.hpp>
+
+#include <stdexcept>
+#include <memory>
+#include <string>
+#include <vector>
+
+struct session {
+  int id = 1;
+  char buffer[2048] = {};
+  std::string user = "guest";
+  std::vector<int> history{1, 2, 3};
+  double timeout = 1.5;
+};
+
+struct not_copyable_field {
+  int value = 0;
+  std::unique_ptr<int> owner;
+};
+
+TEST_CASE("fields_saver_exit") {
+  session s;
+
+  {
+    state_saver::fields_saver_exit<session, int session::*, std::string session::*> state_saver{s, &session::id, &session::user};
+    s.id = 2;
+    s.user = "admin";
+    s.history.push_back(4);
+    s.buffer[0] = 'x';
+  }
+
+  REQUIRE(s.id == 1);
+  REQUIRE(s.user == "guest");
+  REQUIRE(s.history.size() == 4);
+  REQUIRE(s.buffer[0] == 'x');
+}
+
+TEST_CASE("fields_saver_fail") {
+  session s;
+
+  SECTION("exception") {
+    try {
+      state_saver::fields_saver_fail<session, std::vector<int> session::*, double session::*> state_saver{s, &session::history, &session::timeout};
+      s.history.clear();
+      s.timeout = 0.0;
+      throw std::runtime_error{"fail"};
+    } catch (...) {}
+
+    REQUIRE(s.history == std::vector<int>{1, 2, 3});
+    REQUIRE(s.timeout == 1.5);
+  }
+
+  SECTION("no exception") {
+    {
+      state_saver::fields_saver_fail<session, double session::*> state_saver{s, &session::timeout};
+      s.timeout = 0.0;
+    }
+
+    REQUIRE(s.timeout == 0.0);
+  }
+}
+
+TEST_CASE("fields_saver_success") {
+  session s;
+
+  {
+    state_saver::fields_saver_success<session, int session::*> state_saver{s, &session::id};
+    s.id = 2;
+    state_saver.restore();
+    REQUIRE(s.id == 1);
+    s.id = 3;
+    state_saver.dismiss();
+  }
+
+  REQUIRE(s.id == 3);
+}
+
+TEST_CASE("fields_saver move only field") {
+  not_copyable_field s;
+  s.owner.reset(new int{1});
+
+  {
+    state_saver::fields_saver_exit<not_copyable_field, int not_copyable_field::*> state_saver{s, &not_copyable_field::value};
+    s.value = 1;
+  }
+
+  REQUIRE(s.value == 0);
+  REQUIRE(*s.owner == 1);
+}
+
+#if defined(__cpp_deduction_guides) && __cpp_deduction_guides >= 201611L
+TEST_CASE("fields_saver deduction") {
+  session s;
+
+  {
+    state_saver::fields_saver_exit state_saver{s, &session::id, &session::user};
+    s.id = 2;
+    s.user.clear();
+  }
+
+  REQUIRE(s.id == 1);
+  REQUIRE(s.user == "guest");
+}
+#endif
+
+#if defined(__cpp_nontype_template_parameter_auto)
+TEST_CASE("static_fields_saver") {
+  session s;
+
+  SECTION("exit") {
+    {
+      state_saver::static_fields_saver_exit<&session::id, &session::user, &session::timeout> state_saver{s};
+      s.id = 2;
+      s.user = "admin";
+      s.timeout = 0.0;
+    }
+
+    REQUIRE(s.id == 1);
+    REQUIRE(s.user == "guest");
+    REQUIRE(s.timeout == 1.5);
+  }
+
+  SECTION("fail") {
+    try {
+      state_saver::static_fields_saver_fail<&session::history> state_saver{s};
+      s.history.clear();
+      throw std::runtime_error{"fail"};
+    } catch (...) {}
+
+    REQUIRE(s.history.size() == 3);
+  }
+
+  SECTION("member pointers are not stored") {
+    STATIC_REQUIRE(sizeof(state_saver::static_fields_saver_exit<&session::id, &session::timeout>) < sizeof(state_saver::fields_saver_exit<session, int session::*, double session::*>));
+    STATIC_REQUIRE(sizeof(state_saver::static_fields_saver_exit<&session::id, &session::timeout>) < sizeof(session));
+  }
+}
+#endif
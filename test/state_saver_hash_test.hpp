@@ -0,0 +1,184 @@
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2018 - 2021 Daniil Goncharov <neargye@gmail.com>.
+//
+// Permission is hereby  granted, free of charge, to any  person obtaining a copy
+// of this software and associated  documentation files (the "Software"), to deal
+// in the Software  without restriction, including without  limitation the rights
+// to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+// copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <catch.hpp>
+
+#include <state_saver_hash.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#if defined(__linux__)
+#  include <sys/wait.h>
+#  include <unistd.h>
+#endif
+
+namespace {
+
+std::size_t hash_modified_calls = 0;
+
+void count_modified(const void*, std::size_t) noexcept {
+  ++hash_modified_calls;
+}
+
+} // namespace
+
+TEST_CASE("hash_bytes") {
+  REQUIRE(state_saver::hash_bytes("", 0) == 0xEF46DB3751D8E999ULL);
+  REQUIRE(state_saver::hash_bytes("abc", 3) == 0x44BC2CF5AD770999ULL);
+
+  unsigned char buffer[100] = {};
+  const std::uint64_t h = state_saver::hash_bytes(buffer, sizeof(buffer));
+  for (std::size_t i = 0; i < sizeof(buffer); ++i) {
+    buffer[i] = 1;
+    REQUIRE(state_saver::hash_bytes(buffer, sizeof(buffer)) != h);
+    buffer[i] = 0;
+  }
+  REQUIRE(state_saver::hash_bytes(buffer, sizeof(buffer)) == h);
+}
+
+TEST_CASE("hash_saver_exit") {
+  hash_modified_calls = 0;
+  std::uint32_t table[1024] = {};
+
+  SECTION("not modified") {
+    {
+      state_saver::hash_saver_exit state_saver{table, &count_modified};
+      REQUIRE_FALSE(state_saver.modified());
+    }
+    REQUIRE(hash_modified_calls == 0);
+  }
+
+  SECTION("modified") {
+    {
+      state_saver::hash_saver_exit state_saver{table, &count_modified};
+      table[512] = 1;
+      REQUIRE(state_saver.modified());
+    }
+    REQUIRE(hash_modified_calls == 1);
+    REQUIRE(table[512] == 1);
+  }
+
+  SECTION("rehash") {
+    {
+      state_saver::hash_saver_exit state_saver{table, &count_modified};
+      table[0] = 1;
+      state_saver.rehash();
+      REQUIRE_FALSE(state_saver.modified());
+    }
+    REQUIRE(hash_modified_calls == 0);
+  }
+
+  SECTION("dismiss") {
+    {
+      state_saver::hash_saver_exit state_saver{table, &count_modified};
+      table[0] = 1;
+      state_saver.dismiss();
+    }
+    REQUIRE(hash_modified_calls == 0);
+  }
+}
+
+TEST_CASE("hash_saver_success") {
+  hash_modified_calls = 0;
+  std::vector<double> v(4096, 1.0);
+
+  SECTION("no exception") {
+    {
+      state_saver::hash_saver_success state_saver{v.data(), v.size() * sizeof(double), &count_modified};
+      v[4095] = 2.0;
+    }
+    REQUIRE(hash_modified_calls == 1);
+  }
+
+  SECTION("exception") {
+    try {
+      state_saver::hash_saver_success state_saver{v.data(), v.size() * sizeof(double), &count_modified};
+      v[4095] = 2.0;
+      throw std::runtime_error{"fail"};
+    } catch (...) {}
+    REQUIRE(hash_modified_calls == 0);
+  }
+}
+
+TEST_CASE("hash_saver_fail") {
+  hash_modified_calls = 0;
+  int value = 1;
+
+  try {
+    state_saver::hash_saver_fail state_saver{value, &count_modified};
+    value = 2;
+    throw std::runtime_error{"fail"};
+  } catch (...) {}
+
+  REQUIRE(hash_modified_calls == 1);
+}
+
+struct hash_padded {
+  char c;
+  std::uint64_t v;
+};
+
+TEST_CASE("hash_saver_exit: objects with padding") {
+#if defined(__cpp_lib_has_unique_object_representations) && __cpp_lib_has_unique_object_representations >= 201606L
+  STATIC_REQUIRE_FALSE(std::is_constructible<state_saver::hash_saver_exit, const hash_padded&>::value);
+  STATIC_REQUIRE_FALSE(std::is_constructible<state_saver::hash_saver_exit, const double&>::value);
+#endif
+  STATIC_REQUIRE(std::is_constructible<state_saver::hash_saver_exit, const std::uint64_t&>::value);
+  STATIC_REQUIRE(std::is_constructible<state_saver::hash_saver_exit, const std::uint32_t (&)[4]>::value);
+}
+
+#if defined(__linux__)
+TEST_CASE("hash_saver_exit: default handler reports without aborting") {
+  int fds[2];
+  REQUIRE(::pipe(fds) == 0);
+  const pid_t pid = ::fork();
+  REQUIRE(pid >= 0);
+  if (pid == 0) {
+    ::dup2(fds[1], STDERR_FILENO);
+    int value = 1;
+    {
+      state_saver::hash_saver_exit state_saver{value};
+      value = 2;
+    }
+    ::_exit(value == 2 ? 0 : 1);
+  }
+  ::close(fds[1]);
+
+  std::string report;
+  char buffer[256];
+  for (ssize_t n; (n = ::read(fds[0], buffer, sizeof(buffer))) > 0;) {
+    report.append(buffer, static_cast<std::size_t>(n));
+  }
+  ::close(fds[0]);
+
+  int status = 0;
+  REQUIRE(::waitpid(pid, &status, 0) == pid);
+  REQUIRE(WIFEXITED(status));
+  REQUIRE(WEXITSTATUS(status) == 0);
+  REQUIRE(report.find("has been modified") != std::string::npos);
+}
+#endif
@@ -0,0 +1,241 @@
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2018 - 2021 Daniil Goncharov <neargye@gmail.com>.
+//
+// Permission is hereby  granted, free of charge, to any  person obtaining a copy
+// of this software and associated  documentation files (the "Software"), to deal
+// in the Software  without restriction, including without  limitation the rights
+// to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+// copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <catch.hpp>
+
+#include <state_saver_journal.hpp>
+
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+TEST_CASE("journal_saver_fail vector: not called on scope leave") {
+  std::vector<int> v{1, 2, 3};
+  REQUIRE_NOTHROW([&]() {
+    state_saver::journal_saver_fail<decltype(v)> journal{v};
+    journal.push_back(4);
+    journal.set(0, -1);
+  }());
+
+  REQUIRE(v == std::vector<int>{-1, 2, 3, 4});
+}
+
+TEST_CASE("journal_saver_fail vector: called on error") {
+  const std::vector<std::string> original{"a", "b", "c", "d", "e"};
+  std::vector<std::string> v = original;
+  REQUIRE_THROWS([&]() {
+    state_saver::journal_saver_fail<decltype(v)> journal{v};
+    journal.push_back("f");
+    journal.set(0, "x");
+    journal.erase(1);
+    journal.insert(2, "y");
+    journal.pop_back();
+    journal.emplace_back(3, 'z');
+    journal.erase(0, 2);
+    journal.set(0, "w");
+    journal.resize(10);
+    journal.resize(1);
+    journal.resize(4, "v");
+    journal.clear();
+    journal.emplace(0, "u");
+    REQUIRE(journal.get() == std::vector<std::string>{"u"});
+    REQUIRE(journal.operations() == 13);
+    throw std::runtime_error{"error"};
+  }());
+
+  REQUIRE(v == original);
+}
+
+TEST_CASE("journal_saver_exit vector: restore") {
+  std::vector<int> v{1, 2, 3};
+  {
+    state_saver::journal_saver_exit<decltype(v)> journal{v};
+    journal.erase(0);
+    journal.push_back(4);
+    journal.restore();
+    REQUIRE(v == std::vector<int>{1, 2, 3});
+    REQUIRE(journal.operations() == 0);
+    journal.set(2, 5);
+    REQUIRE(journal[2] == 5);
+  }
+
+  REQUIRE(v == std::vector<int>{1, 2, 3});
+}
+
+TEST_CASE("journal_saver_success vector: dismiss") {
+  std::vector<int> v{1, 2, 3};
+  {
+    state_saver::journal_saver_success<decltype(v)> journal{v};
+    journal.resize(5);
+    journal.dismiss();
+  }
+
+  REQUIRE(v == std::vector<int>{1, 2, 3, 0, 0});
+}
+
+TEST_CASE("journal_saver_exit vector: move only type") {
+  std::vector<std::unique_ptr<int>> v;
+  v.emplace_back(new int{1});
+  v.emplace_back(new int{2});
+  {
+    state_saver::journal_saver_exit<decltype(v)> journal{v};
+    journal.erase(0);
+    journal.emplace_back(new int{3});
+    journal.pop_back();
+    journal.clear();
+    REQUIRE(v.empty());
+  }
+
+  REQUIRE(v.size() == 2);
+  REQUIRE(*v[0] == 1);
+  REQUIRE(*v[1] == 2);
+}
+
+TEST_CASE("journal_saver_fail map: called on error") {
+  const std::map<std::string, int> original{{"a", 1}, {"b", 2}, {"c", 3}};
+  std::map<std::string, int> m = original;
+  REQUIRE_THROWS([&]() {
+    state_saver::journal_saver_fail<decltype(m)> journal{m};
+    REQUIRE(journal.insert("d", 4));
+    REQUIRE_FALSE(journal.insert("a", -1));
+    REQUIRE_FALSE(journal.set("a", -1));
+    REQUIRE(journal.set("e", 5));
+    REQUIRE(journal.erase("b") == 1);
+    REQUIRE(journal.erase("x") == 0);
+    REQUIRE(journal.emplace("b", 20));
+    REQUIRE_FALSE(journal.set("d", 40));
+    REQUIRE(journal.at("a") == -1);
+    REQUIRE(journal.count("b") == 1);
+    REQUIRE(journal.operations() == 6);
+    journal.clear();
+    REQUIRE(journal.size() == 0);
+    throw std::runtime_error{"error"};
+  }());
+
+  REQUIRE(m == original);
+}
+
+TEST_CASE("journal_saver_fail map: not called on scope leave") {
+  std::map<int, int> m{{1, 1}};
+  {
+    state_saver::journal_saver_fail<decltype(m)> journal{m};
+    journal.set(1, 2);
+    journal.insert(2, 2);
+  }
+
+  REQUIRE(m == std::map<int, int>{{1, 2}, {2, 2}});
+}
+
+TEST_CASE("journal_saver_exit unordered_map: called on scope leave") {
+  const std::unordered_map<int, std::string> original{{1, "a"}, {2, "b"}};
+  std::unordered_map<int, std::string> m = original;
+  {
+    state_saver::journal_saver_exit<decltype(m)> journal{m};
+    journal.set(1, "x");
+    journal.erase(2);
+    journal.insert(3, "c");
+    journal.set(3, "y");
+    journal.erase(3);
+  }
+
+  REQUIRE(m == original);
+}
+
+TEST_CASE("journal_saver_success unordered_map: restore, dismiss") {
+  std::unordered_map<int, int> m{{1, 1}};
+  {
+    state_saver::journal_saver_success<decltype(m)> journal{m};
+    journal.set(1, 2);
+    journal.restore();
+    REQUIRE(m.at(1) == 1);
+    journal.set(1, 3);
+    journal.dismiss();
+  }
+
+  REQUIRE(m.at(1) == 3);
+}
+
+struct journal_throwing_less {
+  bool operator()(int lhs, int rhs) const {
+    return lhs < rhs;
+  }
+};
+
+struct journal_throwing_value {
+  journal_throwing_value() = default;
+
+  explicit journal_throwing_value(int) {
+    throw std::runtime_error{"value"};
+  }
+};
+
+TEST_CASE("journal_saver_exit map: destructor does not throw if rollback does not") {
+  using map_journal = state_saver::journal_saver_exit<std::map<int, std::string>>;
+  using unordered_journal = state_saver::journal_saver_fail<std::unordered_map<int, std::string>>;
+  using throwing_journal = state_saver::journal_saver_exit<std::map<int, std::string, journal_throwing_less>>;
+  STATIC_REQUIRE(std::is_nothrow_destructible<map_journal>::value == map_journal::is_nothrow_rollback);
+  STATIC_REQUIRE(std::is_nothrow_destructible<unordered_journal>::value == unordered_journal::is_nothrow_rollback);
+  STATIC_REQUIRE_FALSE(unordered_journal::is_nothrow_rollback);
+  STATIC_REQUIRE_FALSE(throwing_journal::is_nothrow_rollback);
+}
+
+TEST_CASE("journal_saver_exit map: failed insert is not recorded") {
+  std::map<int, journal_throwing_value> m;
+  {
+    state_saver::journal_saver_exit<decltype(m)> journal{m};
+    REQUIRE_THROWS(journal.emplace(1, 1));
+    REQUIRE(journal.operations() == 0);
+    journal.emplace(2);
+    REQUIRE(journal.operations() == 1);
+  }
+
+  REQUIRE(m.empty());
+}
+
+#if defined(__cpp_lib_node_extract) && __cpp_lib_node_extract >= 201606L
+TEST_CASE("journal_saver_exit map: erased elements are relinked without allocation") {
+  std::map<int, std::string> m{{1, "one"}, {2, "two"}};
+  std::unordered_map<int, std::string> u{{1, "one"}, {2, "two"}};
+  const std::string* const value = &m.at(1);
+  const std::string* const unordered_value = &u.at(2);
+
+  STATIC_REQUIRE(state_saver::journal_saver_exit<std::map<int, std::string>>::is_nothrow_rollback);
+  {
+    state_saver::journal_saver_exit<std::map<int, std::string>> journal{m};
+    state_saver::journal_saver_exit<std::unordered_map<int, std::string>> unordered_journal{u};
+    journal.erase(1);
+    journal.clear();
+    unordered_journal.erase(2);
+    REQUIRE(m.empty());
+    REQUIRE(u.size() == 1);
+  }
+
+  REQUIRE(m == std::map<int, std::string>{{1, "one"}, {2, "two"}});
+  REQUIRE(&m.at(1) == value);
+  REQUIRE(u.at(2) == "two");
+  REQUIRE(&u.at(2) == unordered_value);
+}
+#endif
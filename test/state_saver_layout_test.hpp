@@ -0,0 +1,62 @@
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2018 - 2021 Daniil Goncharov <neargye@gmail.com>.
+//
+// Permission is hereby  granted, free of charge, to any  person obtaining a copy
+// of this software and associated  documentation files (the "Software"), to deal
+// in the Software  without restriction, including without  limitation the rights
+// to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+// copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <catch.hpp>
+
+#include <state_saver.hpp>
+
+#include <string>
+
+// Itanium C++ ABI reuses tail padding of base classes, the policy shares the last word with the saved value.
+#if (defined(__GNUC__) || defined(__clang__)) && !defined(_WIN32)
+TEST_CASE("layout: policy is placed in the tail padding of the saved value") {
+  STATIC_REQUIRE(sizeof(state_saver::saver_exit<int>) == sizeof(int*) + 2 * sizeof(int));
+  STATIC_REQUIRE(sizeof(state_saver::saver_fail<int>) == sizeof(int*) + 2 * sizeof(int));
+  STATIC_REQUIRE(sizeof(state_saver::saver_success<int>) == sizeof(int*) + 2 * sizeof(int));
+  STATIC_REQUIRE(sizeof(state_saver::saver_exit<char>) <= 2 * sizeof(char*));
+  STATIC_REQUIRE(sizeof(state_saver::swap_saver_fail<int>) == sizeof(int*) + 2 * sizeof(int));
+  STATIC_REQUIRE(sizeof(state_saver::saver_fail<std::string>) == sizeof(std::string*) + sizeof(std::string) + alignof(std::string));
+}
+
+TEST_CASE("layout: saved values of several objects share padding") {
+  STATIC_REQUIRE(sizeof(state_saver::saver_fail<int, int>) <= 2 * sizeof(state_saver::saver_fail<int>));
+  STATIC_REQUIRE(sizeof(state_saver::saver_fail<int, int, int>) <= 3 * sizeof(state_saver::saver_fail<int>));
+  STATIC_REQUIRE(sizeof(state_saver::saver_exit<char, char>) <= 2 * sizeof(state_saver::saver_exit<char>));
+}
+#endif
+
+TEST_CASE("layout: restore does not clobber the policy") {
+  char a = 'a';
+  char b = 'b';
+  {
+    state_saver::saver_fail<char, char> saver{a, b};
+    a = 'c';
+    b = 'd';
+    saver.restore();
+    REQUIRE(a == 'a');
+    REQUIRE(b == 'b');
+    a = 'e';
+  }
+
+  REQUIRE(a == 'e');
+  REQUIRE(b == 'b');
+}
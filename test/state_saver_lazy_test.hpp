@@ -0,0 +1,97 @@
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2018 - 2021 Daniil Goncharov <neargye@gmail.com>.
+//
+// Permission is hereby  granted, free of charge, to any  person obtaining a copy
+// of this software and associated  documentation files (the "Software"), to deal
+// in the Software  without restriction, including without  limitation the rights
+// to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+// copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <catch.hpp>
+
+#include <state_saver.hpp>
+
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+struct lazy_copy_counter {
+  static int copies;
+
+  std::string value;
+
+  explicit lazy_copy_counter(std::string value) : value{std::move(value)} {}
+
+  lazy_copy_counter(const lazy_copy_counter& other) : value{other.value} {
+    ++copies;
+  }
+
+  lazy_copy_counter& operator=(const lazy_copy_counter&) = default;
+};
+
+int lazy_copy_counter::copies = 0;
+
+TEST_CASE("lazy_saver_fail: no copy without write access") {
+  lazy_copy_counter a{"value"};
+  lazy_copy_counter::copies = 0;
+  {
+    state_saver::lazy_saver_fail<decltype(a)> lazy_saver_fail{a};
+    REQUIRE(lazy_saver_fail.cget().value == "value");
+    REQUIRE_FALSE(lazy_saver_fail.is_saved());
+  }
+
+  REQUIRE(lazy_copy_counter::copies == 0);
+}
+
+TEST_CASE("lazy_saver_fail: called on error") {
+  lazy_copy_counter a{"value"};
+  lazy_copy_counter::copies = 0;
+  REQUIRE_THROWS([&]() {
+    state_saver::lazy_saver_fail<decltype(a)> lazy_saver_fail{a};
+    lazy_saver_fail.get().value = "other";
+    lazy_saver_fail.get().value += "other";
+    REQUIRE(lazy_saver_fail.is_saved());
+    throw std::runtime_error{"error"};
+  }());
+
+  REQUIRE(lazy_copy_counter::copies == 1);
+  REQUIRE(a.value == "value");
+}
+
+TEST_CASE("lazy_saver_exit: called on scope leave") {
+  std::string a = "value";
+  {
+    state_saver::lazy_saver_exit<decltype(a)> lazy_saver_exit{a};
+    lazy_saver_exit.get() = "other";
+  }
+
+  REQUIRE(a == "value");
+}
+
+TEST_CASE("lazy_saver_success: restore, dismiss") {
+  std::string a = "value";
+  {
+    state_saver::lazy_saver_success<decltype(a)> lazy_saver_success{a};
+    lazy_saver_success.restore();
+    lazy_saver_success.get() = "other";
+    lazy_saver_success.restore();
+    REQUIRE(a == "value");
+    lazy_saver_success.get() = "other";
+    lazy_saver_success.dismiss();
+  }
+
+  REQUIRE(a == "other");
+}
@@ -0,0 +1,185 @@
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2018 - 2021 Daniil Goncharov <neargye@gmail.com>.
+//
+// Permission is hereby  granted, free of charge, to any  person obtaining a copy
+// of this software and associated  documentation files (the "Software"), to deal
+// in the Software  without restriction, including without  limitation the rights
+// to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+// copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#undef TEST_CLASS_NAME
+#define TEST_CLASS_NAME test_class_multi
+
+#include "test_case.hpp"
+
+CASE_TEST("saver_exit multi: called on scope leave") {
+  test_class a{test_value};
+  int b = test_value;
+  const auto some_function = [](test_class& a, int& b) {
+    saver_exit<decltype(a), decltype(b)> saver_exit{a, b};
+    a.i = other_test_value;
+    b = other_test_value;
+  };
+
+  REQUIRE_NOTHROW([&]() {
+    some_function(a, b);
+  }());
+
+  REQUIRE(a.i == test_value);
+  REQUIRE(b == test_value);
+}
+
+CASE_TEST("saver_fail multi: not called on scope leave") {
+  test_class a{test_value};
+  int b = test_value;
+  const auto some_function = [](test_class& a, int& b) {
+    SAVER_FAIL(a, b);
+    a.i = other_test_value;
+    b = other_test_value;
+  };
+
+  REQUIRE_NOTHROW([&]() {
+    some_function(a, b);
+  }());
+
+  REQUIRE(a.i == other_test_value);
+  REQUIRE(b == other_test_value);
+}
+
+CASE_TEST("saver_fail multi: called on error") {
+  test_class a{test_value};
+  int b = test_value;
+  const auto some_function = [](test_class& a, int& b) {
+    SAVER_FAIL(a, b);
+    a.i = other_test_value;
+    b = other_test_value;
+    throw std::runtime_error{"error"};
+  };
+
+  REQUIRE_THROWS([&]() {
+    some_function(a, b);
+  }());
+
+  REQUIRE(a.i == test_value);
+  REQUIRE(b == test_value);
+}
+
+CASE_TEST("saver_success multi: called on scope leave") {
+  test_class a{test_value};
+  int b = test_value;
+  const auto some_function = [](test_class& a, int& b) {
+    SAVER_SUCCESS(a, b);
+    a.i = other_test_value;
+    b = other_test_value;
+  };
+
+  REQUIRE_NOTHROW([&]() {
+    some_function(a, b);
+  }());
+
+  REQUIRE(a.i == test_value);
+  REQUIRE(b == test_value);
+}
+
+CASE_TEST("saver_success multi: not called on error") {
+  test_class a{test_value};
+  int b = test_value;
+  const auto some_function = [](test_class& a, int& b) {
+    SAVER_SUCCESS(a, b);
+    a.i = other_test_value;
+    b = other_test_value;
+    throw std::runtime_error{"error"};
+  };
+
+  REQUIRE_THROWS([&]() {
+    some_function(a, b);
+  }());
+
+  REQUIRE(a.i == other_test_value);
+  REQUIRE(b == other_test_value);
+}
+
+CASE_TEST("saver_exit multi: dismiss before scope leave") {
+  test_class a{test_value};
+  int b = test_value;
+  const auto some_function = [](test_class& a, int& b) {
+    MAKE_SAVER_EXIT(saver_exit, a, b);
+    a.i = other_test_value;
+    b = other_test_value;
+    saver_exit.dismiss();
+  };
+
+  REQUIRE_NOTHROW([&]() {
+    some_function(a, b);
+  }());
+
+  REQUIRE(a.i == other_test_value);
+  REQUIRE(b == other_test_value);
+}
+
+#if CASE_NUMBER != 3
+CASE_TEST("saver_exit multi: dismiss, restore") {
+  test_class a{test_value};
+  int b = test_value;
+  const auto some_function = [](test_class& a, int& b) {
+    MAKE_SAVER_EXIT(saver_exit, a, b);
+    a.i = other_test_value;
+    b = other_test_value;
+    saver_exit.dismiss();
+    saver_exit.restore();
+    REQUIRE(a.i == test_value);
+    REQUIRE(b == test_value);
+    a.i = other_test_value;
+    b = other_test_value;
+  };
+
+  REQUIRE_NOTHROW_IF(is_nothrow_restore, [&]() {
+    some_function(a, b);
+  }());
+
+  REQUIRE(a.i == other_test_value);
+}
+#endif
+
+#if CASE_NUMBER == 1
+struct restore_order {
+  static std::string log;
+
+  char id;
+
+  explicit restore_order(char id) : id{id} {}
+  restore_order(const restore_order&) = default;
+
+  restore_order& operator=(const restore_order& other) {
+    log.push_back(other.id);
+    return *this;
+  }
+};
+
+std::string restore_order::log;
+
+TEST_CASE("saver_exit multi: restored in reverse order") {
+  restore_order a{'a'};
+  restore_order b{'b'};
+  restore_order c{'c'};
+  restore_order::log.clear();
+  {
+    SAVER_EXIT(a, b, c);
+  }
+
+  REQUIRE(restore_order::log == "cba");
+}
+#endif
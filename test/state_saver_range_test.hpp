@@ -0,0 +1,190 @@
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2018 - 2021 Daniil Goncharov <neargye@gmail.com>.
+//
+// Permission is hereby  granted, free of charge, to any  person obtaining a copy
+// of this software and associated  documentation files (the "Software"), to deal
+// in the Software  without restriction, including without  limitation the rights
+// to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+// copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <catch.hpp>
+
+#include <state_saver_range.hpp>
+
+#include <array>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+TEST_CASE("range_saver_exit") {
+  SECTION("pointers") {
+    int buffer[64] = {};
+    {
+      state_saver::range_saver_exit<int> state_saver{buffer + 16, buffer + 32};
+      REQUIRE(state_saver.size() == 16);
+      REQUIRE(state_saver.data() == buffer + 16);
+      for (int& i : buffer) {
+        i = 1;
+      }
+    }
+    REQUIRE(buffer[15] == 1);
+    REQUIRE(buffer[16] == 0);
+    REQUIRE(buffer[31] == 0);
+    REQUIRE(buffer[32] == 1);
+  }
+
+  SECTION("array") {
+    unsigned char buffer[4096] = {};
+    {
+      state_saver::range_saver_exit<unsigned char> state_saver{buffer, 1024, 1024};
+      REQUIRE(state_saver.size() == 1024);
+      for (unsigned char& c : buffer) {
+        c = 0xFF;
+      }
+    }
+    REQUIRE(buffer[1023] == 0xFF);
+    REQUIRE(buffer[1024] == 0);
+    REQUIRE(buffer[2047] == 0);
+    REQUIRE(buffer[2048] == 0xFF);
+  }
+
+  SECTION("not trivially copyable") {
+    std::vector<std::string> v{"a", "b", "c", "d"};
+    {
+      state_saver::range_saver_exit<std::string> state_saver{v, 1, 2};
+      v[0] = "x";
+      v[1] = "y";
+      v[2] = "z";
+    }
+    REQUIRE(v == std::vector<std::string>{"x", "b", "c", "d"});
+  }
+
+  SECTION("empty") {
+    std::vector<int> v;
+    {
+      state_saver::range_saver_exit<int> state_saver{v, 0, 0};
+      REQUIRE(state_saver.size() == 0);
+    }
+    REQUIRE(v.empty());
+  }
+
+  SECTION("out of range") {
+    std::vector<int> v(8);
+    REQUIRE_THROWS_AS(state_saver::range_saver_exit<int>(v, 4, 5), std::out_of_range);
+    REQUIRE_THROWS_AS(state_saver::range_saver_exit<int>(v, 9, 0), std::out_of_range);
+    REQUIRE_NOTHROW(state_saver::range_saver_exit<int>(v, 8, 0));
+  }
+}
+
+namespace {
+
+struct range_counted {
+  static int assignments;
+  int value;
+
+  range_counted(int v) : value{v} {}
+  range_counted(const range_counted&) = default;
+
+  range_counted& operator=(const range_counted& other) {
+    ++assignments;
+    value = other.value;
+    return *this;
+  }
+
+  bool operator==(const range_counted& other) const {
+    return value == other.value;
+  }
+};
+
+int range_counted::assignments = 0;
+
+} // namespace
+
+TEST_CASE("range_saver_exit: unchanged elements") {
+  std::vector<range_counted> v{1, 2, 3, 4};
+  {
+    state_saver::range_saver_exit<range_counted> state_saver{v, 0, 4};
+    range_counted::assignments = 0;
+    v[1].value = 0;
+  }
+  REQUIRE(v[1].value == 2);
+#if defined(STATE_SAVER_COMPARE_BEFORE_RESTORE)
+  REQUIRE(range_counted::assignments == 1);
+#else
+  REQUIRE(range_counted::assignments == 4);
+#endif
+}
+
+TEST_CASE("range_saver_fail") {
+  std::array<double, 16> a{};
+
+  SECTION("exception") {
+    try {
+      state_saver::range_saver_fail<double> state_saver{a, 4, 4};
+      a.fill(1.0);
+      throw std::runtime_error{"fail"};
+    } catch (...) {}
+    REQUIRE(a[3] == 1.0);
+    REQUIRE(a[4] == 0.0);
+    REQUIRE(a[7] == 0.0);
+    REQUIRE(a[8] == 1.0);
+  }
+
+  SECTION("no exception") {
+    {
+      state_saver::range_saver_fail<double> state_saver{a.data(), a.size()};
+      a.fill(1.0);
+    }
+    REQUIRE(a[0] == 1.0);
+  }
+}
+
+TEST_CASE("range_saver_success") {
+  std::vector<int> v{1, 2, 3, 4};
+
+  {
+    state_saver::range_saver_success<int> state_saver{v, 0, 2};
+    v[0] = 0;
+    state_saver.restore();
+    REQUIRE(v[0] == 1);
+    v[1] = 0;
+    state_saver.dismiss();
+  }
+
+  REQUIRE(v == std::vector<int>{1, 0, 3, 4});
+}
+
+#if defined(__cpp_deduction_guides) && __cpp_deduction_guides >= 201611L
+TEST_CASE("range_saver deduction") {
+  int buffer[8] = {};
+  std::vector<std::string> v{"a", "b"};
+
+  {
+    state_saver::range_saver_exit s1{buffer, 2, 4};
+    state_saver::range_saver_exit s2{buffer + 6, buffer + 8};
+    state_saver::range_saver_exit s3{v, 1, 1};
+    for (int& i : buffer) {
+      i = 1;
+    }
+    v[1] = "x";
+  }
+
+  REQUIRE(buffer[1] == 1);
+  REQUIRE(buffer[2] == 0);
+  REQUIRE(buffer[6] == 0);
+  REQUIRE(v[1] == "b");
+}
+#endif
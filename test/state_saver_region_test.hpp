@@ -0,0 +1,284 @@
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2018 - 2021 Daniil Goncharov <neargye@gmail.com>.
+//
+// Permission is hereby  granted, free of charge, to any  person obtaining a copy
+// of this software and associated  documentation files (the "Software"), to deal
+// in the Software  without restriction, including without  limitation the rights
+// to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+// copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#if defined(__linux__)
+
+#include <catch.hpp>
+
+#include <state_saver_region.hpp>
+
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+class region_test_buffer {
+  std::size_t size_;
+  unsigned char* data_;
+
+ public:
+  explicit region_test_buffer(std::size_t pages)
+      : size_{pages * static_cast<std::size_t>(::sysconf(_SC_PAGESIZE))},
+        data_{static_cast<unsigned char*>(::mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0))} {
+    REQUIRE(data_ != MAP_FAILED);
+    for (std::size_t i = 0; i < size_; ++i) {
+      data_[i] = static_cast<unsigned char>(i % 251);
+    }
+  }
+
+  ~region_test_buffer() {
+    ::munmap(data_, size_);
+  }
+
+  unsigned char* data() const noexcept { return data_; }
+
+  std::size_t size() const noexcept { return size_; }
+
+  std::size_t page() const noexcept { return static_cast<std::size_t>(::sysconf(_SC_PAGESIZE)); }
+
+  bool unchanged(std::size_t first, std::size_t last) const noexcept {
+    for (std::size_t i = first; i < last; ++i) {
+      if (data_[i] != static_cast<unsigned char>(i % 251)) {
+        return false;
+      }
+    }
+    return true;
+  }
+};
+
+TEST_CASE("region_saver_exit: only written pages are saved and restored") {
+  region_test_buffer b{16};
+  {
+    state_saver::region_saver_exit saver{b.data(), b.size()};
+    REQUIRE(saver.dirty_pages() == 0);
+    b.data()[0] = 0xFF;
+    b.data()[1] = 0xFF;
+    b.data()[5 * b.page() + 7] = 0xFF;
+    REQUIRE(b.data()[5 * b.page() + 7] == 0xFF);
+    REQUIRE(saver.dirty_pages() == 2);
+
+    std::size_t bytes = 0;
+    saver.for_each_dirty([&](void*, std::size_t size) { bytes += size; });
+    REQUIRE(bytes == 2 * b.page());
+  }
+
+  REQUIRE(b.unchanged(0, b.size()));
+}
+
+TEST_CASE("region_saver_fail: called on error") {
+  region_test_buffer b{4};
+  REQUIRE_THROWS([&]() {
+    state_saver::region_saver_fail saver{b.data(), b.size()};
+    std::memset(b.data(), 0, b.size());
+    throw std::runtime_error{"error"};
+  }());
+
+  REQUIRE(b.unchanged(0, b.size()));
+}
+
+TEST_CASE("region_saver_fail: not called on scope leave") {
+  region_test_buffer b{4};
+  {
+    state_saver::region_saver_fail saver{b.data(), b.size()};
+    b.data()[b.page()] = 0xFF;
+  }
+
+  REQUIRE(b.data()[b.page()] == 0xFF);
+  b.data()[b.page() + 1] = 0xFF;
+}
+
+TEST_CASE("region_saver_success: restore, dismiss") {
+  region_test_buffer b{4};
+  {
+    state_saver::region_saver_success saver{b.data(), b.size()};
+    b.data()[0] = 0xFF;
+    saver.restore();
+    REQUIRE(saver.dirty_pages() == 0);
+    REQUIRE(b.unchanged(0, b.size()));
+    b.data()[b.page()] = 0xFF;
+    REQUIRE(saver.dirty_pages() == 1);
+    saver.dismiss();
+  }
+
+  REQUIRE(b.data()[b.page()] == 0xFF);
+  REQUIRE(b.unchanged(0, b.page()));
+}
+
+TEST_CASE("region_saver_exit: partial pages outside the region are not restored") {
+  region_test_buffer b{4};
+  {
+    state_saver::region_saver_exit saver{b.data() + 100, 2 * b.page()};
+    b.data()[50] = 0xFF;
+    b.data()[150] = 0xFF;
+    b.data()[2 * b.page() + 150] = 0xFF;
+  }
+
+  REQUIRE(b.data()[50] == 0xFF);
+  REQUIRE(b.data()[2 * b.page() + 150] == 0xFF);
+  REQUIRE(b.data()[150] == static_cast<unsigned char>(150 % 251));
+}
+
+TEST_CASE("region_saver_exit: prepare_write before kernel writes") {
+  region_test_buffer b{4};
+  std::vector<unsigned char> zeros(64, 0);
+  {
+    state_saver::region_saver_exit saver{b.data(), b.size()};
+    saver.prepare_write(b.data() + b.page() - 32, 64);
+    REQUIRE(saver.dirty_pages() == 2);
+    int fds[2];
+    REQUIRE(::pipe(fds) == 0);
+    REQUIRE(::write(fds[1], zeros.data(), zeros.size()) == 64);
+    REQUIRE(::read(fds[0], b.data() + b.page() - 32, 64) == 64);
+    ::close(fds[0]);
+    ::close(fds[1]);
+  }
+
+  REQUIRE(b.unchanged(0, b.size()));
+}
+
+TEST_CASE("region_saver_exit: nested savers on the same pages") {
+  region_test_buffer b{4};
+  const unsigned char first = b.data()[0];
+  const unsigned char second = b.data()[b.page()];
+  {
+    state_saver::region_saver_exit outer{b.data(), b.size()};
+    b.data()[0] = 2;
+    {
+      state_saver::region_saver_exit inner{b.data(), b.size()};
+      b.data()[0] = 3;
+      REQUIRE(inner.dirty_pages() == 1);
+    }
+    REQUIRE(b.data()[0] == 2);
+
+    // Inner saver has not unprotected the page still watched by the outer one.
+    b.data()[b.page()] = 3;
+    REQUIRE(outer.dirty_pages() == 2);
+  }
+
+  REQUIRE(b.data()[0] == first);
+  REQUIRE(b.data()[b.page()] == second);
+  REQUIRE(b.unchanged(0, b.size()));
+}
+
+TEST_CASE("region_saver_exit: adjacent regions on one page") {
+  region_test_buffer b{2};
+  {
+    state_saver::region_saver_exit left{b.data(), 100};
+    {
+      state_saver::region_saver_exit right{b.data() + 100, 100};
+      b.data()[100] = 2;
+      REQUIRE(left.dirty_pages() == 1);
+      REQUIRE(right.dirty_pages() == 1);
+    }
+    REQUIRE(b.unchanged(100, 200));
+
+    left.restore();
+    b.data()[50] = 2;
+    b.data()[100] = 2;
+    REQUIRE(left.dirty_pages() == 1);
+  }
+
+  REQUIRE(b.unchanged(0, 100));
+  REQUIRE(b.data()[100] == 2);
+}
+
+TEST_CASE("region_saver_exit: savers on one page destroyed out of order") {
+  region_test_buffer b{2};
+  std::unique_ptr<state_saver::region_saver_exit> left{new state_saver::region_saver_exit{b.data(), 100}};
+  std::unique_ptr<state_saver::region_saver_exit> right{new state_saver::region_saver_exit{b.data() + 100, 100}};
+  left.reset();
+  b.data()[150] = 2;
+  REQUIRE(right->dirty_pages() == 1);
+  right.reset();
+
+  REQUIRE(b.unchanged(0, b.size()));
+  b.data()[150] = 2;
+}
+
+// Without kernel soft-dirty support every page of the region is reported as written.
+TEST_CASE("soft_dirty_saver_exit: written pages are restored") {
+  region_test_buffer b{16};
+  {
+    state_saver::soft_dirty_saver_exit saver{b.data(), b.size()};
+    b.data()[0] = 0xFF;
+    b.data()[5 * b.page() + 7] = 0xFF;
+    const std::size_t dirty = saver.dirty_pages();
+    REQUIRE((dirty == 2 || dirty == 16));
+
+    std::size_t bytes = 0;
+    saver.for_each_dirty([&](void*, std::size_t size) { bytes += size; });
+    REQUIRE(bytes == dirty * b.page());
+  }
+
+  REQUIRE(b.unchanged(0, b.size()));
+}
+
+TEST_CASE("soft_dirty_saver_fail: called on error") {
+  region_test_buffer b{4};
+  REQUIRE_THROWS([&]() {
+    state_saver::soft_dirty_saver_fail saver{b.data(), b.size()};
+    std::memset(b.data(), 0, b.size());
+    throw std::runtime_error{"error"};
+  }());
+
+  REQUIRE(b.unchanged(0, b.size()));
+}
+
+TEST_CASE("soft_dirty_saver_success: restore, dismiss") {
+  region_test_buffer b{4};
+  {
+    state_saver::soft_dirty_saver_success saver{b.data(), b.size()};
+    b.data()[0] = 0xFF;
+    saver.restore();
+    REQUIRE(b.unchanged(0, b.size()));
+    b.data()[b.page()] = 0xFF;
+    saver.dismiss();
+  }
+
+  REQUIRE(b.data()[b.page()] == 0xFF);
+  REQUIRE(b.unchanged(0, b.page()));
+}
+
+TEST_CASE("soft_dirty_saver_exit: nested savers keep writes made before the inner one") {
+  region_test_buffer b{4};
+  {
+    state_saver::soft_dirty_saver_exit outer{b.data(), b.size()};
+    b.data()[0] = 0xFF;
+    {
+      state_saver::soft_dirty_saver_exit inner{b.data() + 100, 2 * b.page()};
+      b.data()[50] = 0xFF;
+      b.data()[150] = 0xFF;
+      b.data()[3 * b.page()] = 0xFF;
+    }
+    REQUIRE(b.data()[50] == 0xFF);
+    REQUIRE(b.data()[150] == static_cast<unsigned char>(150 % 251));
+    REQUIRE(outer.dirty_pages() >= 2);
+  }
+
+  REQUIRE(b.unchanged(0, b.size()));
+}
+
+#endif
@@ -0,0 +1,89 @@
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2018 - 2021 Daniil Goncharov <neargye@gmail.com>.
+//
+// Permission is hereby  granted, free of charge, to any  person obtaining a copy
+// of this software and associated  documentation files (the "Software"), to deal
+// in the Software  without restriction, including without  limitation the rights
+// to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+// copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <catch.hpp>
+
+#include <state_saver_registry.hpp>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST_CASE("saver_registry: rollback_all restores enlisted objects") {
+  int a = 1;
+  std::string s = "buffer";
+  std::vector<int> v{1, 2, 3};
+
+  state_saver::saver_registry registry;
+  registry.enlist(a, s);
+  registry.enlist(v);
+  a = 2;
+  s.clear();
+  registry.enlist(a);
+  a = 3;
+  v.clear();
+  REQUIRE(registry.size() == 4);
+
+  registry.rollback_all();
+  REQUIRE(registry.size() == 0);
+  REQUIRE(a == 1);
+  REQUIRE(s == "buffer");
+  REQUIRE(v == std::vector<int>{1, 2, 3});
+}
+
+TEST_CASE("saver_registry: commit_all keeps changes") {
+  int a = 1;
+  state_saver::saver_registry registry;
+  registry.enlist(a);
+  a = 2;
+  registry.commit_all();
+  registry.rollback_all();
+
+  REQUIRE(a == 2);
+}
+
+namespace {
+
+thread_local int registry_test_knob = 0;
+
+void registry_test_task(int value) {
+  state_saver::enlist(registry_test_knob);
+  registry_test_knob = value;
+}
+
+} // namespace
+
+TEST_CASE("saver_registry: each thread has its own registry") {
+  std::vector<int> seen;
+  std::thread worker([&seen]() {
+    for (int task = 1; task <= 3; ++task) {
+      registry_test_task(task);
+      seen.push_back(registry_test_knob);
+      state_saver::saver_registry::current().rollback_all();
+      seen.push_back(registry_test_knob);
+    }
+  });
+  worker.join();
+
+  REQUIRE(seen == std::vector<int>{1, 0, 2, 0, 3, 0});
+  REQUIRE(state_saver::saver_registry::current().size() == 0);
+}
@@ -0,0 +1,143 @@
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2018 - 2021 Daniil Goncharov <neargye@gmail.com>.
+//
+// Permission is hereby  granted, free of charge, to any  person obtaining a copy
+// of this software and associated  documentation files (the "Software"), to deal
+// in the Software  without restriction, including without  limitation the rights
+// to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+// copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <catch.hpp>
+
+#include <state_saver_savepoint.hpp>
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+TEST_CASE("savepoint_saver_exit: rollback to a savepoint") {
+  int a = 0;
+  std::string s = "0";
+  {
+    state_saver::savepoint_saver_exit<int, std::string> saver{a, s};
+    const std::size_t sp0 = saver.mark();
+    saver.get<0>() = 1;
+    const std::size_t sp1 = saver.mark();
+    saver.get<0>() = 2;
+    saver.get<1>() = "2";
+    const std::size_t sp2 = saver.mark();
+    saver.get<0>() = 3;
+    saver.get<1>() = "3";
+    REQUIRE(saver.depth() == 3);
+
+    saver.rollback(sp1);
+    REQUIRE(a == 1);
+    REQUIRE(s == "0");
+    REQUIRE(saver.depth() == 2);
+
+    saver.rollback(sp2);
+    REQUIRE(saver.depth() == 2);
+
+    saver.get<1>() = "4";
+    saver.rollback(sp0);
+    REQUIRE(a == 0);
+    REQUIRE(s == "0");
+    REQUIRE(saver.depth() == 1);
+    REQUIRE(saver.snapshots() == 0);
+
+    saver.get<0>() = 5;
+  }
+
+  REQUIRE(a == 0);
+}
+
+TEST_CASE("savepoint_saver_exit: release merges snapshots into the parent") {
+  int a = 0;
+  int b = 0;
+  {
+    state_saver::savepoint_saver_exit<int, int> saver{a, b};
+    const std::size_t sp0 = saver.mark();
+    saver.get<0>() = 1;
+    for (int i = 0; i < 100; ++i) {
+      const std::size_t sp = saver.mark();
+      saver.get<0>() = i;
+      saver.get<1>() = i;
+      saver.release(sp);
+    }
+    // a is saved once by the first savepoint, b is saved once after being merged.
+    REQUIRE(saver.depth() == 1);
+    REQUIRE(saver.snapshots() == 2);
+
+    saver.rollback(sp0);
+    REQUIRE(a == 0);
+    REQUIRE(b == 0);
+
+    saver.get<0>() = 7;
+    saver.release(sp0);
+    REQUIRE(saver.depth() == 0);
+    REQUIRE(saver.snapshots() == 0);
+  }
+
+  REQUIRE(a == 7);
+}
+
+TEST_CASE("savepoint_saver_fail: backtracking search") {
+  std::vector<int> path;
+  int cost = 0;
+  {
+    state_saver::savepoint_saver_fail<std::vector<int>, int> saver{path, cost};
+    for (int step = 1; step <= 4; ++step) {
+      const std::size_t sp = saver.mark();
+      saver.get<0>().push_back(step);
+      saver.get<1>() += step;
+      if (saver.cget<1>() > 6) {
+        saver.rollback(sp);
+        saver.release(sp);
+      }
+    }
+    REQUIRE(saver.depth() == 3);
+  }
+
+  REQUIRE(path == std::vector<int>{1, 2, 3});
+  REQUIRE(cost == 6);
+}
+
+TEST_CASE("savepoint_saver_fail: called on error") {
+  int a = 0;
+  REQUIRE_THROWS([&]() {
+    state_saver::savepoint_saver_fail<int> saver{a};
+    saver.mark();
+    saver.get<0>() = 1;
+    saver.mark();
+    saver.get<0>() = 2;
+    throw std::runtime_error{"error"};
+  }());
+
+  REQUIRE(a == 0);
+}
+
+TEST_CASE("savepoint_saver_success: dismiss") {
+  int a = 0;
+  {
+    state_saver::savepoint_saver_success<int> saver{a};
+    saver.mark();
+    saver.get<0>() = 1;
+    saver.dismiss();
+  }
+
+  REQUIRE(a == 1);
+}
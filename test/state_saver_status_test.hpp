@@ -0,0 +1,146 @@
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2018 - 2021 Daniil Goncharov <neargye@gmail.com>.
+//
+// Permission is hereby  granted, free of charge, to any  person obtaining a copy
+// of this software and associated  documentation files (the "Software"), to deal
+// in the Software  without restriction, including without  limitation the rights
+// to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+// copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <catch.hpp>
+
+#include <state_saver.hpp>
+
+#include <string>
+#include <system_error>
+
+#if defined(__has_include)
+#  if __has_include(<optional>) && __cplusplus >= 201703L
+#    include <optional>
+#    define STATE_SAVER_TEST_OPTIONAL 1
+#  endif
+#endif
+
+// Minimal expected-like result.
+struct status_result {
+  bool ok = true;
+
+  bool has_value() const noexcept { return ok; }
+};
+
+// errno-like status, zero is success.
+struct errno_status {
+  int value = 0;
+};
+
+namespace state_saver {
+
+template <>
+struct status_traits<errno_status> {
+  static bool failed(const errno_status& status) noexcept {
+    return status.value != 0;
+  }
+};
+
+} // namespace state_saver
+
+TEST_CASE("status_saver_fail: bool status") {
+  std::string s = "original";
+  bool ok = true;
+  {
+    state_saver::status_saver_fail<std::string, bool> saver{s, ok};
+    s = "changed";
+    ok = false;
+  }
+  REQUIRE(s == "original");
+
+  {
+    state_saver::status_saver_fail<std::string, bool> saver{s, ok};
+    s = "changed";
+    ok = true;
+  }
+  REQUIRE(s == "changed");
+}
+
+TEST_CASE("status_saver_fail: error_code status") {
+  int a = 1;
+  std::error_code ec;
+  {
+    state_saver::status_saver_fail<int, std::error_code> saver{a, ec};
+    a = 2;
+  }
+  REQUIRE(a == 2);
+
+  {
+    state_saver::status_saver_fail<int, std::error_code> saver{a, ec};
+    a = 3;
+    ec = std::make_error_code(std::errc::invalid_argument);
+  }
+  REQUIRE(a == 2);
+}
+
+TEST_CASE("status_saver_success: expected-like and custom status") {
+  int a = 1;
+  status_result result;
+  {
+    state_saver::status_saver_success<int, status_result> saver{a, result};
+    a = 2;
+  }
+  REQUIRE(a == 1);
+
+  result.ok = false;
+  {
+    state_saver::status_saver_success<int, status_result> saver{a, result};
+    a = 2;
+  }
+  REQUIRE(a == 2);
+
+  errno_status status;
+  {
+    state_saver::status_saver_fail<int, errno_status> saver{a, status};
+    a = 3;
+    status.value = 22;
+  }
+  REQUIRE(a == 2);
+}
+
+TEST_CASE("status_saver_fail: restore, dismiss") {
+  int a = 1;
+  bool ok = false;
+  {
+    state_saver::status_saver_fail<int, bool> saver{a, ok};
+    a = 2;
+    saver.restore();
+    REQUIRE(a == 1);
+    a = 3;
+    saver.dismiss();
+  }
+
+  REQUIRE(a == 3);
+}
+
+#if defined(STATE_SAVER_TEST_OPTIONAL)
+TEST_CASE("status_saver_fail: optional status, deduction guide") {
+  int a = 1;
+  std::optional<int> value;
+  {
+    state_saver::status_saver_fail saver{a, value};
+    a = 2;
+  }
+
+  REQUIRE(a == 1);
+}
+#endif
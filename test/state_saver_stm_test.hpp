@@ -0,0 +1,113 @@
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2018 - 2021 Daniil Goncharov <neargye@gmail.com>.
+//
+// Permission is hereby  granted, free of charge, to any  person obtaining a copy
+// of this software and associated  documentation files (the "Software"), to deal
+// in the Software  without restriction, including without  limitation the rights
+// to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+// copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <catch.hpp>
+
+#include <state_saver_stm.hpp>
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST_CASE("transaction: commit publishes written copies") {
+  state_saver::tvar<int> a{1};
+  state_saver::tvar<std::string> s{"config"};
+
+  state_saver::transaction t;
+  t.write(a) += 1;
+  t.write(s) += " v2";
+  REQUIRE(t.read(a) == 2);
+  REQUIRE(a.load() == 1);
+  REQUIRE(t.size() == 2);
+
+  REQUIRE(t.commit());
+  REQUIRE(t.size() == 0);
+  REQUIRE(a.load() == 2);
+  REQUIRE(s.load() == "config v2");
+  REQUIRE(a.version() == 1);
+}
+
+TEST_CASE("transaction: conflicting commit is discarded") {
+  state_saver::tvar<int> a{1};
+  state_saver::tvar<int> b{10};
+
+  state_saver::transaction t1;
+  state_saver::transaction t2;
+  t1.write(b) = t1.read(a) + 1;
+  t2.write(a) = 5;
+  REQUIRE(t2.commit());
+
+  REQUIRE_FALSE(t1.valid());
+  REQUIRE_FALSE(t1.commit());
+  REQUIRE(a.load() == 5);
+  REQUIRE(b.load() == 10);
+}
+
+TEST_CASE("transaction: read-only access of another variable does not conflict") {
+  state_saver::tvar<int> a{1};
+  state_saver::tvar<int> b{10};
+
+  state_saver::transaction t1;
+  state_saver::transaction t2;
+  t1.write(a) = t1.read(a) + 1;
+  static_cast<void>(t2.read(a));
+  t2.write(b) = 11;
+  REQUIRE(t1.commit());
+  REQUIRE_FALSE(t2.commit());
+  REQUIRE(b.load() == 10);
+}
+
+TEST_CASE("atomically: shared variables unchanged on error") {
+  state_saver::tvar<int> a{1};
+  REQUIRE_THROWS([&]() {
+    state_saver::atomically([&](state_saver::transaction& t) {
+      t.write(a) = 2;
+      throw std::runtime_error{"error"};
+    });
+  }());
+
+  REQUIRE(a.load() == 1);
+}
+
+TEST_CASE("atomically: concurrent transfers keep the total") {
+  state_saver::tvar<int> from{100000};
+  state_saver::tvar<int> to{0};
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; ++i) {
+    threads.emplace_back([&]() {
+      for (int j = 0; j < 1000; ++j) {
+        state_saver::atomically([&](state_saver::transaction& t) {
+          t.write(from) -= 1;
+          t.write(to) += 1;
+        });
+      }
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+
+  REQUIRE(from.load() == 96000);
+  REQUIRE(to.load() == 4000);
+}
@@ -0,0 +1,106 @@
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2018 - 2021 Daniil Goncharov <neargye@gmail.com>.
+//
+// Permission is hereby  granted, free of charge, to any  person obtaining a copy
+// of this software and associated  documentation files (the "Software"), to deal
+// in the Software  without restriction, including without  limitation the rights
+// to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+// copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <catch.hpp>
+
+#include <state_saver.hpp>
+
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+struct swap_copy_counter {
+  static int copies;
+
+  std::vector<int> data;
+
+  swap_copy_counter() = default;
+
+  explicit swap_copy_counter(std::vector<int> data) : data{std::move(data)} {}
+
+  swap_copy_counter(const swap_copy_counter& other) : data{other.data} {
+    ++copies;
+  }
+
+  swap_copy_counter(swap_copy_counter&&) = default;
+
+  swap_copy_counter& operator=(const swap_copy_counter& other) {
+    data = other.data;
+    ++copies;
+    return *this;
+  }
+
+  swap_copy_counter& operator=(swap_copy_counter&&) = default;
+};
+
+int swap_copy_counter::copies = 0;
+
+TEST_CASE("swap_saver_exit: moves the object out and back without copies") {
+  swap_copy_counter::copies = 0;
+  swap_copy_counter c{{1, 2, 3}};
+  const int* const buffer = c.data.data();
+  {
+    state_saver::swap_saver_exit<swap_copy_counter> saver{c};
+    REQUIRE(c.data.empty());
+    c.data.assign(10, 0);
+  }
+
+  REQUIRE(c.data == std::vector<int>{1, 2, 3});
+  REQUIRE(c.data.data() == buffer);
+  REQUIRE(swap_copy_counter::copies == 0);
+}
+
+TEST_CASE("swap_saver_fail: replacement value, called on error") {
+  std::string s = "original string which does not fit in the small buffer";
+  REQUIRE_THROWS([&]() {
+    state_saver::swap_saver_fail<std::string> saver{s, "replacement"};
+    REQUIRE(s == "replacement");
+    s += " changed";
+    throw std::runtime_error{"error"};
+  }());
+
+  REQUIRE(s == "original string which does not fit in the small buffer");
+}
+
+TEST_CASE("swap_saver_fail: not called on scope leave") {
+  std::vector<int> v{1, 2, 3};
+  {
+    state_saver::swap_saver_fail<std::vector<int>> saver{v};
+    v.push_back(4);
+  }
+
+  REQUIRE(v == std::vector<int>{4});
+}
+
+TEST_CASE("swap_saver_success: restore consumes the saved value") {
+  std::vector<int> v{1, 2, 3};
+  {
+    state_saver::swap_saver_success<std::vector<int>> saver{v, std::vector<int>{7}};
+    REQUIRE(v == std::vector<int>{7});
+    saver.restore();
+    REQUIRE(v == std::vector<int>{1, 2, 3});
+    v.push_back(4);
+  }
+
+  REQUIRE(v == std::vector<int>{1, 2, 3, 4});
+}
@@ -0,0 +1,112 @@
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2018 - 2021 Daniil Goncharov <neargye@gmail.com>.
+//
+// Permission is hereby  granted, free of charge, to any  person obtaining a copy
+// of this software and associated  documentation files (the "Software"), to deal
+// in the Software  without restriction, including without  limitation the rights
+// to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+// copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <catch.hpp>
+
+#include <state_saver.hpp>
+
+#include <stdexcept>
+#include <string>
+
+struct trivial_block {
+  int header;
+  unsigned char payload[4096];
+};
+
+struct trivial_empty {};
+
+// Not POD for layout purposes, so a derived class may place its members in the tail padding.
+class trivial_base {
+  int a;
+  char b;
+
+ public:
+  void set(int x) {
+    a = x;
+    b = 0;
+  }
+};
+
+struct trivial_derived : trivial_base {
+  char c;
+};
+
+static_assert(state_saver::detail::is_trivially_restorable<int>::value, "");
+static_assert(state_saver::detail::is_trivially_restorable<trivial_block>::value, "");
+static_assert(!state_saver::detail::is_trivially_restorable<trivial_empty>::value, "");
+static_assert(!state_saver::detail::is_trivially_restorable<volatile int>::value, "");
+static_assert(!state_saver::detail::is_trivially_restorable<std::string>::value, "");
+
+TEST_CASE("trivially restorable: saver_exit called on scope leave") {
+  trivial_block b{};
+  b.header = 1;
+  b.payload[4095] = 1;
+  {
+    state_saver::saver_exit<decltype(b)> saver_exit{b};
+    b.header = -1;
+    b.payload[4095] = 2;
+  }
+
+  REQUIRE(b.header == 1);
+  REQUIRE(b.payload[4095] == 1);
+}
+
+TEST_CASE("trivially restorable: saver_fail called on error") {
+  trivial_block b{};
+  b.header = 1;
+  REQUIRE_THROWS([&]() {
+    state_saver::saver_fail<decltype(b)> saver_fail{b};
+    b.header = -1;
+    throw std::runtime_error{"error"};
+  }());
+
+  REQUIRE(b.header == 1);
+}
+
+TEST_CASE("trivially restorable: restore") {
+  trivial_block b{};
+  b.header = 1;
+  {
+    state_saver::saver_success<decltype(b)> saver_success{b};
+    b.header = -1;
+    saver_success.restore();
+    REQUIRE(b.header == 1);
+    b.header = -1;
+    saver_success.dismiss();
+  }
+
+  REQUIRE(b.header == -1);
+}
+
+TEST_CASE("trivially restorable: base subobject restore keeps derived members") {
+  trivial_derived d{};
+  d.set(1);
+  d.c = 7;
+  trivial_base& b = d;
+  {
+    SAVER_EXIT(b);
+    b.set(2);
+    d.c = 9;
+  }
+
+  REQUIRE(d.c == 9);
+}
@@ -24,28 +24,53 @@
 #include "state_saver_exit_test.hpp"
 #include "state_saver_success_test.hpp"
 #include "state_saver_fail_test.hpp"
+#include "state_saver_multi_test.hpp"
 #undef CASE_NUMBER
 
 #define CASE_NUMBER 2
 #include "state_saver_exit_test.hpp"
 #include "state_saver_success_test.hpp"
 #include "state_saver_fail_test.hpp"
+#include "state_saver_multi_test.hpp"
 #undef CASE_NUMBER
 
 #define CASE_NUMBER 3
 #include "state_saver_exit_test.hpp"
 #include "state_saver_success_test.hpp"
 #include "state_saver_fail_test.hpp"
+#include "state_saver_multi_test.hpp"
 #undef CASE_NUMBER
 
 #define CASE_NUMBER 4
 #include "state_saver_exit_test.hpp"
 #include "state_saver_success_test.hpp"
 #include "state_saver_fail_test.hpp"
+#include "state_saver_multi_test.hpp"
 #undef CASE_NUMBER
 
 #define CASE_NUMBER 5
 #include "state_saver_exit_test.hpp"
 #include "state_saver_success_test.hpp"
 #include "state_saver_fail_test.hpp"
+#include "state_saver_multi_test.hpp"
 #undef CASE_NUMBER
+
+#include "state_saver_trivial_test.hpp"
+#include "state_saver_compare_test.hpp"
+#include "state_saver_journal_test.hpp"
+#include "state_saver_lazy_test.hpp"
+#include "state_saver_region_test.hpp"
+#include "state_saver_allocator_test.hpp"
+#include "state_saver_swap_test.hpp"
+#include "state_saver_layout_test.hpp"
+#include "state_saver_status_test.hpp"
+#include "state_saver_savepoint_test.hpp"
+#include "state_saver_stm_test.hpp"
+#include "state_saver_atomic_test.hpp"
+#include "state_saver_registry_test.hpp"
+#include "state_saver_coroutine_test.hpp"
+#include "state_saver_fields_test.hpp"
+#include "state_saver_range_test.hpp"
+#include "state_saver_diff_test.hpp"
+#include "state_saver_compressed_test.hpp"
+#include "state_saver_hash_test.hpp"